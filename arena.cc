@@ -25,30 +25,132 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+#define __STDC_LIMIT_MACROS
+
+// C
+#include <assert.h>
+
+// STL
+#include <algorithm>
+
 // e
 #include "e/arena.h"
+#include "e/arena_chunk_source.h"
+#include "e/atomic.h"
 #include "e/buffer.h"
+#include "e/pow2.h"
 
 using e::arena;
 
+namespace
+{
+
+uint64_t g_reserved = 0;
+uint64_t g_used = 0;
+uint64_t g_chunks = 0;
+uint64_t g_fallbacks = 0;
+uint64_t g_takeovers = 0;
+uint64_t g_peak_reserved = 0;
+uint64_t g_peak_used = 0;
+
+void
+raise_peak(uint64_t *peak, uint64_t value)
+{
+	uint64_t old = e::atomic::load_64_nobarrier(peak);
+
+	while (old < value)
+	{
+		uint64_t witness = e::atomic::compare_and_swap_64_nobarrier(peak, old, value);
+
+		if (witness == old)
+		{
+			break;
+		}
+
+		old = witness;
+	}
+}
+
+} // namespace
+
+const size_t arena::DEFAULT_INITIAL_CHUNK;
+const size_t arena::DEFAULT_MAX_CHUNK;
+
 arena :: arena()
 	: m_to_free()
 	, m_buffers()
+	, m_destructors()
+	, m_chunks()
+	, m_spare()
+	, m_large()
+	, m_source(NULL)
+	, m_chunk_bytes(0)
+	, m_start()
+	, m_limit()
+	, m_next_chunk(DEFAULT_INITIAL_CHUNK)
+	, m_max_chunk(DEFAULT_MAX_CHUNK)
+	, m_used(0)
+	, m_fallback_bytes(0)
+	, m_chunk_count(0)
+	, m_fallbacks(0)
+	, m_takeovers(0)
+	, m_peak_reserved(0)
+	, m_peak_used(0)
+	, m_takeovers_reported(0)
+{
+}
+
+arena :: arena(size_t initial_chunk, size_t max_chunk)
+	: m_to_free()
+	, m_buffers()
+	, m_destructors()
+	, m_chunks()
+	, m_spare()
+	, m_large()
+	, m_source(NULL)
+	, m_chunk_bytes(0)
 	, m_start()
 	, m_limit()
+	, m_next_chunk(std::min(initial_chunk, max_chunk))
+	, m_max_chunk(max_chunk)
+	, m_used(0)
+	, m_fallback_bytes(0)
+	, m_chunk_count(0)
+	, m_fallbacks(0)
+	, m_takeovers(0)
+	, m_peak_reserved(0)
+	, m_peak_used(0)
+	, m_takeovers_reported(0)
+{
+}
+
+arena :: arena(size_t initial_chunk, size_t max_chunk, arena_chunk_source *source)
+	: m_to_free()
+	, m_buffers()
+	, m_destructors()
+	, m_chunks()
+	, m_spare()
+	, m_large()
+	, m_source(source)
+	, m_chunk_bytes(0)
+	, m_start()
+	, m_limit()
+	, m_next_chunk(std::min(initial_chunk, max_chunk))
+	, m_max_chunk(max_chunk)
+	, m_used(0)
+	, m_fallback_bytes(0)
+	, m_chunk_count(0)
+	, m_fallbacks(0)
+	, m_takeovers(0)
+	, m_peak_reserved(0)
+	, m_peak_used(0)
+	, m_takeovers_reported(0)
 {
 }
 
 arena :: ~arena()
 {
-	for (size_t i = 0; i < m_to_free.size(); ++i)
-	{
-		free(m_to_free[i]);
-	}
-	for (size_t i = 0; i < m_buffers.size(); ++i)
-	{
-		delete m_buffers[i];
-	}
+	clear();
 }
 
 void
@@ -58,12 +160,9 @@ arena :: reserve(size_t sz)
 	{
 		return;
 	}
-	unsigned char *tmp = NULL;
-	raw_allocate(sz, &tmp);
-	if (tmp)
+	if (!take_spare(sz))
 	{
-		m_start = tmp;
-		m_limit = m_start + sz;
+		new_chunk(sz);
 	}
 }
 
@@ -76,15 +175,56 @@ arena :: allocate(size_t sz, char **ptr)
 void
 arena :: allocate(size_t sz, unsigned char **ptr)
 {
-	if (m_start + sz <= m_limit)
-	{
-		*ptr = m_start;
-		m_start += sz;
-	}
-	else
+	allocate(sz, 1, ptr);
+}
+
+void
+arena :: allocate(size_t sz, size_t align, unsigned char **ptr)
+{
+	assert(is_pow2(align));
+	size_t pad = -reinterpret_cast<uintptr_t>(m_start) & (align - 1);
+
+	if (pad > static_cast<size_t>(m_limit - m_start) ||
+	    sz > static_cast<size_t>(m_limit - m_start) - pad)
 	{
-		raw_allocate(sz, ptr);
+		if (sz > SIZE_MAX - align)
+		{
+			*ptr = NULL;
+			return;
+		}
+		const size_t padded = sz + align - 1;
+
+		// Requests that would use most of a chunk get memory of their own, so
+		// that the space left in the current chunk is not thrown away.
+		if (m_max_chunk == 0 || padded > m_max_chunk / 2)
+		{
+			unsigned char *tmp = NULL;
+			raw_allocate(padded, &tmp);
+			pad = -reinterpret_cast<uintptr_t>(tmp) & (align - 1);
+			*ptr = tmp ? tmp + pad : NULL;
+			m_used += tmp ? sz : 0;
+			return;
+		}
+
+		if (!take_spare(padded))
+		{
+			new_chunk(std::max(padded, m_next_chunk));
+			m_next_chunk = std::min(std::max(m_next_chunk, padded) * 2, m_max_chunk);
+		}
+
+		pad = -reinterpret_cast<uintptr_t>(m_start) & (align - 1);
+
+		if (pad > static_cast<size_t>(m_limit - m_start) ||
+		    sz > static_cast<size_t>(m_limit - m_start) - pad)
+		{
+			*ptr = NULL;
+			return;
+		}
 	}
+
+	*ptr = m_start + pad;
+	m_start += pad + sz;
+	m_used += sz;
 }
 
 void
@@ -97,17 +237,37 @@ void
 arena :: takeover(unsigned char *ptr)
 {
 	m_to_free.push_back(ptr);
+	++m_takeovers;
 }
 
 void
 arena :: takeover(e::buffer *buf)
 {
 	m_buffers.push_back(buf);
+	++m_takeovers;
 }
 
 void
 arena :: clear()
 {
+	reset(0);
+}
+
+void
+arena :: reset()
+{
+	size_t largest = 0;
+	for (size_t i = 0; i < m_chunks.size(); ++i)
+	{
+		largest = std::max(largest, m_chunks[i].size);
+	}
+	reset(largest);
+}
+
+void
+arena :: reset(size_t retain)
+{
+	run_destructors();
 	for (size_t i = 0; i < m_to_free.size(); ++i)
 	{
 		free(m_to_free[i]);
@@ -116,15 +276,183 @@ arena :: clear()
 	{
 		delete m_buffers[i];
 	}
+	m_to_free.clear();
+	m_buffers.clear();
+
+	for (size_t i = 0; i < m_large.size(); ++i)
+	{
+		source_deallocate(m_large[i].base, m_large[i].size);
+	}
+	m_large.clear();
+
+	std::sort(m_chunks.begin(), m_chunks.end(), chunk::larger);
+	std::vector<chunk> kept;
+	size_t kept_bytes = 0;
+	for (size_t i = 0; i < m_chunks.size(); ++i)
+	{
+		if (m_chunks[i].size <= retain - kept_bytes)
+		{
+			if (m_source)
+			{
+				m_source->recycle(m_chunks[i].base, m_chunks[i].size);
+			}
+			kept.push_back(m_chunks[i]);
+			kept_bytes += m_chunks[i].size;
+		}
+		else
+		{
+			source_deallocate(m_chunks[i].base, m_chunks[i].size);
+		}
+	}
+
+	const uint64_t released = m_chunk_bytes - kept_bytes + m_fallback_bytes;
+	e::atomic::increment_64_nobarrier(&g_reserved, -released);
+	e::atomic::increment_64_nobarrier(&g_used, m_used);
+	e::atomic::increment_64_nobarrier(&g_takeovers, m_takeovers - m_takeovers_reported);
+	raise_peak(&g_peak_used, m_used);
+	m_peak_used = std::max(m_peak_used, m_used);
+	m_used = 0;
+	m_fallback_bytes = 0;
+	m_takeovers_reported = m_takeovers;
+
+	m_chunks.swap(kept);
+	m_chunk_bytes = kept_bytes;
+	m_spare = m_chunks;
+	m_start = NULL;
+	m_limit = NULL;
+
+	if (!m_spare.empty())
+	{
+		m_start = m_spare[0].base;
+		m_limit = m_start + m_spare[0].size;
+		m_spare.erase(m_spare.begin());
+	}
+}
+
+arena :: stats :: stats()
+	: bytes_reserved(0)
+	, bytes_used(0)
+	, chunks(0)
+	, fallbacks(0)
+	, takeovers(0)
+	, peak_reserved(0)
+	, peak_used(0)
+{
+}
+
+void
+arena :: statistics(stats *s) const
+{
+	s->bytes_reserved = m_chunk_bytes + m_fallback_bytes;
+	s->bytes_used = m_used;
+	s->chunks = m_chunk_count;
+	s->fallbacks = m_fallbacks;
+	s->takeovers = m_takeovers;
+	s->peak_reserved = m_peak_reserved;
+	s->peak_used = std::max(m_peak_used, m_used);
+}
+
+void
+arena :: global_statistics(stats *s)
+{
+	s->bytes_reserved = e::atomic::load_64_nobarrier(&g_reserved);
+	s->bytes_used = e::atomic::load_64_nobarrier(&g_used);
+	s->chunks = e::atomic::load_64_nobarrier(&g_chunks);
+	s->fallbacks = e::atomic::load_64_nobarrier(&g_fallbacks);
+	s->takeovers = e::atomic::load_64_nobarrier(&g_takeovers);
+	s->peak_reserved = e::atomic::load_64_nobarrier(&g_peak_reserved);
+	s->peak_used = e::atomic::load_64_nobarrier(&g_peak_used);
+}
+
+void
+arena :: run_destructors()
+{
+	while (!m_destructors.empty())
+	{
+		destructor d = m_destructors.back();
+		m_destructors.pop_back();
+		if (d.func)
+		{
+			d.func(d.obj);
+		}
+	}
+}
+
+bool
+arena :: take_spare(size_t sz)
+{
+	// m_spare is sorted largest first, so the last chunk that fits wastes
+	// the least space
+	for (size_t i = m_spare.size(); i > 0; --i)
+	{
+		if (m_spare[i - 1].size >= sz)
+		{
+			m_start = m_spare[i - 1].base;
+			m_limit = m_start + m_spare[i - 1].size;
+			m_spare.erase(m_spare.begin() + i - 1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void
+arena :: new_chunk(size_t sz)
+{
+	unsigned char *tmp = source_allocate(&sz);
+	if (tmp)
+	{
+		m_chunks.push_back(chunk(tmp, sz));
+		m_chunk_bytes += sz;
+		m_start = tmp;
+		m_limit = m_start + sz;
+		++m_chunk_count;
+		account(sz, &g_chunks);
+	}
 }
 
 void
 arena :: raw_allocate(size_t sz, unsigned char **ptr)
 {
-	unsigned char *tmp = reinterpret_cast<unsigned char *>(malloc(sz));
+	unsigned char *tmp = source_allocate(&sz);
 	*ptr = tmp;
 	if (tmp)
 	{
-		m_to_free.push_back(tmp);
+		m_large.push_back(chunk(tmp, sz));
+		m_fallback_bytes += sz;
+		++m_fallbacks;
+		account(sz, &g_fallbacks);
 	}
 }
+
+unsigned char *
+arena :: source_allocate(size_t *sz)
+{
+	if (m_source)
+	{
+		return m_source->allocate(sz);
+	}
+	return static_cast<unsigned char *>(malloc(*sz));
+}
+
+void
+arena :: source_deallocate(unsigned char *ptr, size_t sz)
+{
+	if (m_source)
+	{
+		m_source->deallocate(ptr, sz);
+	}
+	else
+	{
+		free(ptr);
+	}
+}
+
+void
+arena :: account(size_t sz, uint64_t *counter)
+{
+	m_peak_reserved = std::max<uint64_t>(m_peak_reserved, m_chunk_bytes + m_fallback_bytes);
+	e::atomic::increment_64_nobarrier(counter, 1);
+	raise_peak(&g_peak_reserved, e::atomic::increment_64_nobarrier(&g_reserved, sz));
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <stdint.h>
+
+// POSIX
+#include <sys/mman.h>
+#include <unistd.h>
+
+// e
+#include "e/arena_chunk_source.h"
+
+using e::arena_chunk_source;
+using e::mmap_chunk_source;
+
+namespace
+{
+
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+} // namespace
+
+arena_chunk_source :: arena_chunk_source()
+{
+}
+
+arena_chunk_source :: ~arena_chunk_source() throw ()
+{
+}
+
+void
+arena_chunk_source :: recycle(unsigned char *, size_t)
+{
+}
+
+mmap_chunk_source :: mmap_chunk_source(bool huge_pages, bool release_on_reset)
+	: m_huge_pages(huge_pages)
+	, m_release_on_reset(release_on_reset)
+	, m_granularity(huge_pages ? HUGE_PAGE_SIZE : sysconf(_SC_PAGESIZE))
+{
+}
+
+mmap_chunk_source :: ~mmap_chunk_source() throw ()
+{
+}
+
+unsigned char *
+mmap_chunk_source :: allocate(size_t *sz)
+{
+	if (*sz > static_cast<size_t>(-1) - 2 * m_granularity)
+	{
+		return NULL;
+	}
+
+	const size_t rounded = (*sz + m_granularity - 1) & ~(m_granularity - 1);
+	// over-map by one unit of granularity so the chunk can be aligned on it
+	const size_t mapped = m_huge_pages ? rounded + m_granularity : rounded;
+	void *ptr = mmap(NULL, mapped, PROT_READ | PROT_WRITE,
+	                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (ptr == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	unsigned char *base = static_cast<unsigned char *>(ptr);
+
+	if (m_huge_pages)
+	{
+		const size_t head = -reinterpret_cast<uintptr_t>(base) & (m_granularity - 1);
+		const size_t tail = mapped - rounded - head;
+
+		if (head)
+		{
+			munmap(base, head);
+		}
+
+		if (tail)
+		{
+			munmap(base + head + rounded, tail);
+		}
+
+		base += head;
+#ifdef MADV_HUGEPAGE
+		madvise(base, rounded, MADV_HUGEPAGE);
+#endif
+	}
+
+	*sz = rounded;
+	return base;
+}
+
+void
+mmap_chunk_source :: deallocate(unsigned char *ptr, size_t sz)
+{
+	munmap(ptr, sz);
+}
+
+void
+mmap_chunk_source :: recycle(unsigned char *ptr, size_t sz)
+{
+	if (m_release_on_reset)
+	{
+		madvise(ptr, sz, MADV_DONTNEED);
+	}
+}
@@ -0,0 +1,275 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <assert.h>
+#include <stdlib.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include "e/arena_pool.h"
+#include "e/atomic.h"
+
+using e::arena;
+using e::arena_pool;
+
+struct arena_pool::thread_cache
+{
+	thread_cache(arena_pool *p) : pool(p), arenas() {}
+	~thread_cache() throw () {}
+
+	arena_pool *pool;
+	std::vector<arena *> arenas;
+
+private:
+	thread_cache(const thread_cache &);
+	thread_cache &operator = (const thread_cache &);
+};
+
+arena_pool :: arena_pool()
+	: m_key()
+	, m_per_thread(8)
+	, m_retain(0)
+	, m_initial_chunk(arena::DEFAULT_INITIAL_CHUNK)
+	, m_max_chunk(arena::DEFAULT_MAX_CHUNK)
+	, m_source(NULL)
+	, m_prewarm(0)
+	, m_mtx()
+	, m_shared()
+	, m_caches()
+	, m_hits(0)
+	, m_misses(0)
+	, m_retained(0)
+{
+	if (pthread_key_create(&m_key, &arena_pool::thread_exit) != 0)
+	{
+		abort();
+	}
+}
+
+arena_pool :: arena_pool(size_t per_thread, size_t retain)
+	: m_key()
+	, m_per_thread(per_thread)
+	, m_retain(retain)
+	, m_initial_chunk(arena::DEFAULT_INITIAL_CHUNK)
+	, m_max_chunk(arena::DEFAULT_MAX_CHUNK)
+	, m_source(NULL)
+	, m_prewarm(0)
+	, m_mtx()
+	, m_shared()
+	, m_caches()
+	, m_hits(0)
+	, m_misses(0)
+	, m_retained(0)
+{
+	if (pthread_key_create(&m_key, &arena_pool::thread_exit) != 0)
+	{
+		abort();
+	}
+}
+
+arena_pool :: arena_pool(size_t per_thread, size_t retain,
+                         size_t initial_chunk, size_t max_chunk,
+                         arena_chunk_source *source, size_t prewarm)
+	: m_key()
+	, m_per_thread(per_thread)
+	, m_retain(retain)
+	, m_initial_chunk(initial_chunk)
+	, m_max_chunk(max_chunk)
+	, m_source(source)
+	, m_prewarm(prewarm)
+	, m_mtx()
+	, m_shared()
+	, m_caches()
+	, m_hits(0)
+	, m_misses(0)
+	, m_retained(0)
+{
+	if (pthread_key_create(&m_key, &arena_pool::thread_exit) != 0)
+	{
+		abort();
+	}
+}
+
+arena_pool :: ~arena_pool() throw ()
+{
+	// Deleting the key does not run thread_exit, so clean up every cache
+	// that is still registered by hand.
+	pthread_key_delete(m_key);
+
+	for (size_t i = 0; i < m_caches.size(); ++i)
+	{
+		for (size_t j = 0; j < m_caches[i]->arenas.size(); ++j)
+		{
+			delete m_caches[i]->arenas[j];
+		}
+
+		delete m_caches[i];
+	}
+
+	for (size_t i = 0; i < m_shared.size(); ++i)
+	{
+		delete m_shared[i];
+	}
+}
+
+arena *
+arena_pool :: acquire()
+{
+	thread_cache *tc = get_cache();
+	arena *a = NULL;
+
+	if (!tc->arenas.empty())
+	{
+		a = tc->arenas.back();
+		tc->arenas.pop_back();
+	}
+	else
+	{
+		po6::threads::mutex::hold hold(&m_mtx);
+
+		if (!m_shared.empty())
+		{
+			a = m_shared.back();
+			m_shared.pop_back();
+		}
+	}
+
+	if (a)
+	{
+		account(a, false);
+		e::atomic::increment_64_nobarrier(&m_hits, 1);
+		return a;
+	}
+
+	e::atomic::increment_64_nobarrier(&m_misses, 1);
+	return create();
+}
+
+void
+arena_pool :: release(arena *a)
+{
+	if (m_retain == 0)
+	{
+		a->reset();
+	}
+	else
+	{
+		a->reset(m_retain);
+	}
+
+	account(a, true);
+	thread_cache *tc = get_cache();
+
+	if (tc->arenas.size() < m_per_thread)
+	{
+		tc->arenas.push_back(a);
+		return;
+	}
+
+	po6::threads::mutex::hold hold(&m_mtx);
+	m_shared.push_back(a);
+}
+
+uint64_t
+arena_pool :: hits() const
+{
+	return e::atomic::load_64_nobarrier(&m_hits);
+}
+
+uint64_t
+arena_pool :: misses() const
+{
+	return e::atomic::load_64_nobarrier(&m_misses);
+}
+
+uint64_t
+arena_pool :: retained_bytes() const
+{
+	return e::atomic::load_64_nobarrier(&m_retained);
+}
+
+void
+arena_pool :: thread_exit(void *_tc)
+{
+	thread_cache *tc = static_cast<thread_cache *>(_tc);
+	arena_pool *pool = tc->pool;
+	po6::threads::mutex::hold hold(&pool->m_mtx);
+	pool->m_shared.insert(pool->m_shared.end(), tc->arenas.begin(), tc->arenas.end());
+	pool->m_caches.erase(std::find(pool->m_caches.begin(), pool->m_caches.end(), tc));
+	delete tc;
+}
+
+arena *
+arena_pool :: create()
+{
+	arena *a = new arena(m_initial_chunk, m_max_chunk, m_source);
+
+	if (m_prewarm > 0)
+	{
+		a->reserve(m_prewarm);
+	}
+
+	return a;
+}
+
+arena_pool::thread_cache *
+arena_pool :: get_cache()
+{
+	thread_cache *tc = static_cast<thread_cache *>(pthread_getspecific(m_key));
+
+	if (tc)
+	{
+		return tc;
+	}
+
+	tc = new thread_cache(this);
+	tc->arenas.reserve(m_per_thread);
+
+	{
+		po6::threads::mutex::hold hold(&m_mtx);
+		m_caches.push_back(tc);
+	}
+
+	if (pthread_setspecific(m_key, tc) != 0)
+	{
+		abort();
+	}
+
+	return tc;
+}
+
+void
+arena_pool :: account(arena *a, bool add)
+{
+	// unsigned wrap-around makes adding the negation a subtraction
+	const uint64_t bytes = a->retained();
+	e::atomic::increment_64_nobarrier(&m_retained, add ? bytes : -bytes);
+}
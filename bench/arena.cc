@@ -0,0 +1,97 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Compare the rate of small allocations served by e::arena with chunking
+// against the behavior of an arena that falls back to malloc once the
+// reserve()d region is exhausted, and against one arena recycled with reset().
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <iostream>
+
+// e
+#include "e/arena.h"
+
+// bench
+#include "bench/bench.h"
+
+namespace
+{
+
+const size_t ROUNDS = 1000;
+const size_t ALLOCATIONS = 10000;
+
+double
+run(size_t initial_chunk, size_t max_chunk, bool recycle)
+{
+	e::arena recycled(initial_chunk, max_chunk);
+	const uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		e::arena fresh(initial_chunk, max_chunk);
+		e::arena &a(recycle ? recycled : fresh);
+		a.reserve(4096);
+
+		for (size_t i = 0; i < ALLOCATIONS; ++i)
+		{
+			unsigned char *ptr = NULL;
+			a.allocate(16 + (i % 8) * 16, &ptr);
+			ptr[0] = i;
+			bench::use(ptr);
+		}
+
+		if (recycle)
+		{
+			a.reset(a.retained());
+		}
+	}
+
+	const uint64_t end = bench::now();
+	const double secs = (end - start) / 1e9;
+	return (ROUNDS * ALLOCATIONS) / secs;
+}
+
+} // namespace
+
+int
+main(int, char *[])
+{
+	const double legacy = run(0, 0, false);
+	std::cout << "malloc on overflow:     " << legacy << " allocations/s" << std::endl;
+	const double chunked = run(e::arena::DEFAULT_INITIAL_CHUNK, e::arena::DEFAULT_MAX_CHUNK, false);
+	std::cout << "chunked (default sizes): " << chunked << " allocations/s "
+	          << "(" << chunked / legacy << "x)" << std::endl;
+	const double recycled = run(e::arena::DEFAULT_INITIAL_CHUNK, e::arena::DEFAULT_MAX_CHUNK, true);
+	std::cout << "chunked, reset():        " << recycled << " allocations/s "
+	          << "(" << recycled / legacy << "x)" << std::endl;
+	return EXIT_SUCCESS;
+}
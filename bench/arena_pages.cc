@@ -0,0 +1,100 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Fill a large arena with small objects and report the page faults and time
+// taken with malloc-backed chunks and with each mmap_chunk_source policy.
+// The first argument is the size of the arena in MB (default 256).
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// POSIX
+#include <sys/resource.h>
+
+// STL
+#include <iostream>
+
+// e
+#include "e/arena.h"
+#include "e/arena_chunk_source.h"
+
+// bench
+#include "bench/bench.h"
+
+namespace
+{
+
+const size_t OBJECT = 64;
+
+long
+minor_faults()
+{
+	rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_minflt;
+}
+
+void
+run(const char *name, e::arena_chunk_source *source, size_t bytes)
+{
+	const long faults = minor_faults();
+	const uint64_t start = bench::now();
+
+	{
+		e::arena a(1 << 20, 64 << 20, source);
+
+		for (size_t i = 0; i < bytes / OBJECT; ++i)
+		{
+			unsigned char *ptr = NULL;
+			a.allocate(OBJECT, &ptr);
+			ptr[0] = i;
+			ptr[OBJECT - 1] = i;
+			bench::use(ptr);
+		}
+	}
+
+	const uint64_t end = bench::now();
+	std::cout << name << ": " << minor_faults() - faults << " minor faults, "
+	          << (end - start) / 1e6 << " ms" << std::endl;
+}
+
+} // namespace
+
+int
+main(int argc, char *argv[])
+{
+	const size_t mb = argc > 1 ? strtoul(argv[1], NULL, 10) : 256;
+	const size_t bytes = mb << 20;
+	e::mmap_chunk_source small_pages(false, false);
+	e::mmap_chunk_source huge_pages(true, false);
+	run("malloc", NULL, bytes);
+	run("mmap", &small_pages, bytes);
+	run("mmap, huge pages", &huge_pages, bytes);
+	return EXIT_SUCCESS;
+}
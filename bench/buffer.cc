@@ -0,0 +1,138 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Compare packing a batch of records into an e::buffer sized up front by a
+// pack_size() pass against packing into a buffer that grows geometrically,
+// either from scratch each round or reusing the previous round's buffer.
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <iostream>
+
+// e
+#include "e/buffer.h"
+#include "e/serialization.h"
+
+// bench
+#include "bench/bench.h"
+
+namespace
+{
+
+const size_t ROUNDS = 100;
+const size_t RECORDS = 10000;
+const char PAYLOAD[] = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+
+e::slice
+payload(size_t i)
+{
+	return e::slice(PAYLOAD, 16 + (i % 4) * 16);
+}
+
+double
+two_pass()
+{
+	const uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		size_t sz = 0;
+
+		for (size_t i = 0; i < RECORDS; ++i)
+		{
+			sz += sizeof(uint64_t) + sizeof(uint32_t) + e::pack_size(payload(i));
+		}
+
+		e::buffer *buf = e::buffer::create(sz);
+		e::packer p = buf->pack_at(0);
+
+		for (size_t i = 0; i < RECORDS; ++i)
+		{
+			p = p << uint64_t(i) << uint32_t(r) << payload(i);
+		}
+
+		bench::use(buf->data());
+		delete buf;
+	}
+
+	const uint64_t end = bench::now();
+	return (ROUNDS * RECORDS) / ((end - start) / 1e9);
+}
+
+double
+growable(bool reuse)
+{
+	e::buffer *kept = NULL;
+	const uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		e::buffer *buf = kept;
+
+		if (buf)
+		{
+			buf->resize(0);
+		}
+
+		e::packer p(&buf, 0);
+
+		for (size_t i = 0; i < RECORDS; ++i)
+		{
+			p = p << uint64_t(i) << uint32_t(r) << payload(i);
+		}
+
+		bench::use(buf->data());
+
+		if (reuse)
+		{
+			kept = buf;
+		}
+		else
+		{
+			delete buf;
+		}
+	}
+
+	const uint64_t end = bench::now();
+	delete kept;
+	return (ROUNDS * RECORDS) / ((end - start) / 1e9);
+}
+
+} // namespace
+
+int
+main(int, const char *[])
+{
+	std::cout << "two-pass:  " << two_pass() << " records/s" << std::endl;
+	std::cout << "growable:  " << growable(false) << " records/s" << std::endl;
+	std::cout << "reused:    " << growable(true) << " records/s" << std::endl;
+	return EXIT_SUCCESS;
+}
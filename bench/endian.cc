@@ -0,0 +1,163 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Pack and unpack 1M big-endian uint64s one at a time: through an
+// out-of-line, byte-at-a-time copy of the functions endian.cc used to
+// define, and through the inline functions in e/endian.h.
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <iostream>
+#include <vector>
+
+// e
+#include "e/endian.h"
+
+// bench
+#include "bench/bench.h"
+
+namespace
+{
+
+const size_t VALUES = 1000000;
+const size_t ROUNDS = 100;
+
+__attribute__ ((noinline)) uint8_t *
+old_pack64be(uint64_t number, uint8_t *buffer)
+{
+	buffer[0] = number >> 56;
+	buffer[1] = (number >> 48) & 0xff;
+	buffer[2] = (number >> 40) & 0xff;
+	buffer[3] = (number >> 32) & 0xff;
+	buffer[4] = (number >> 24) & 0xff;
+	buffer[5] = (number >> 16) & 0xff;
+	buffer[6] = (number >> 8) & 0xff;
+	buffer[7] = number & 0xff;
+	return buffer + sizeof(uint64_t);
+}
+
+__attribute__ ((noinline)) const uint8_t *
+old_unpack64be(const uint8_t *buffer, uint64_t *number)
+{
+	*number = static_cast<uint64_t>(buffer[0]) << 56
+	          | static_cast<uint64_t>(buffer[1]) << 48
+	          | static_cast<uint64_t>(buffer[2]) << 40
+	          | static_cast<uint64_t>(buffer[3]) << 32
+	          | static_cast<uint64_t>(buffer[4]) << 24
+	          | static_cast<uint64_t>(buffer[5]) << 16
+	          | static_cast<uint64_t>(buffer[6]) << 8
+	          | static_cast<uint64_t>(buffer[7]);
+	return buffer + sizeof(uint64_t);
+}
+
+void
+report(const char *name, uint64_t start, uint64_t end)
+{
+	const double secs = (end - start) / 1e9;
+	std::cout << name << ": " << (ROUNDS * VALUES) / secs / 1e6
+	          << "M integers/s" << std::endl;
+}
+
+} // namespace
+
+int
+main(int, const char *[])
+{
+	std::vector<uint64_t> values(VALUES);
+	std::vector<uint8_t> buf(VALUES * sizeof(uint64_t));
+
+	for (size_t i = 0; i < VALUES; ++i)
+	{
+		values[i] = i * 0x9e3779b97f4a7c15ULL;
+	}
+
+	uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		uint8_t *ptr = &buf[0];
+
+		for (size_t i = 0; i < VALUES; ++i)
+		{
+			ptr = old_pack64be(values[i], ptr);
+		}
+
+		bench::use(ptr);
+	}
+
+	report("pack64be out of line", start, bench::now());
+	start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		uint8_t *ptr = &buf[0];
+
+		for (size_t i = 0; i < VALUES; ++i)
+		{
+			ptr = e::pack64be(values[i], ptr);
+		}
+
+		bench::use(ptr);
+	}
+
+	report("pack64be inline", start, bench::now());
+	start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		const uint8_t *ptr = &buf[0];
+
+		for (size_t i = 0; i < VALUES; ++i)
+		{
+			ptr = old_unpack64be(ptr, &values[i]);
+		}
+
+		bench::use(values[0]);
+	}
+
+	report("unpack64be out of line", start, bench::now());
+	start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		const uint8_t *ptr = &buf[0];
+
+		for (size_t i = 0; i < VALUES; ++i)
+		{
+			ptr = e::unpack64be(ptr, &values[i]);
+		}
+
+		bench::use(values[0]);
+	}
+
+	report("unpack64be inline", start, bench::now());
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Decode 1M uint32 postings-style values (mostly small) encoded as varints,
+// group varints and stream vbytes, to help choose a format at write time.
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <iostream>
+#include <vector>
+
+// e
+#include "e/group_varint.h"
+#include "e/varint.h"
+
+// bench
+#include "bench/bench.h"
+
+namespace
+{
+
+const size_t VALUES = 1000000;
+const size_t ROUNDS = 50;
+
+void
+report(const char *name, uint64_t start, uint64_t end)
+{
+	const double secs = (end - start) / 1e9;
+	std::cout << name << ": " << (ROUNDS * VALUES) / secs / 1e6
+	          << "M values/s" << std::endl;
+}
+
+} // namespace
+
+int
+main(int, const char *[])
+{
+	std::vector<uint32_t> values(VALUES);
+	std::vector<uint64_t> wide(VALUES);
+	uint64_t seed = 0x9e3779b97f4a7c15ULL;
+
+	// gaps between sorted document ids: mostly one or two bytes
+	for (size_t i = 0; i < VALUES; ++i)
+	{
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		values[i] = static_cast<uint32_t>(seed >> 32) >> (16 + (seed & 15));
+		wide[i] = values[i];
+	}
+
+	std::vector<uint8_t> varints(e::varint_length_n(&wide[0], VALUES));
+	std::vector<uint8_t> group(e::group_varint_length(&values[0], VALUES));
+	std::vector<uint8_t> stream(e::stream_vbyte_length(&values[0], VALUES));
+	e::varint64_encode_n(&varints[0], &wide[0], VALUES);
+	e::group_varint_encode(&group[0], &values[0], VALUES);
+	e::stream_vbyte_encode(&stream[0], &values[0], VALUES);
+	std::cout << "varint " << varints.size() << " bytes, group varint "
+	          << group.size() << " bytes" << std::endl;
+	uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		bench::use(e::varint64_decode_n(&varints[0], &varints[0] + varints.size(), &wide[0], VALUES));
+	}
+
+	report("varint", start, bench::now());
+	start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		bench::use(e::group_varint_decode(&group[0], &group[0] + group.size(), &values[0], VALUES));
+	}
+
+	report("group varint", start, bench::now());
+	start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		bench::use(e::stream_vbyte_decode(&stream[0], &stream[0] + stream.size(), &values[0], VALUES));
+	}
+
+	report("stream vbyte", start, bench::now());
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Compare e::packer, which goes through a shared_ptr and a virtual
+// bytes_manager for every value, with e::static_packer writing into the
+// same e::buffer through a buffer_sink.  Messages are packed field by field,
+// and as a struct that only has an e::packer operator<< (as types declared
+// with E_SERIALIZATION_TRIPLET do), which static_packer falls back to.
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <iostream>
+#include <memory>
+
+// e
+#include "e/buffer.h"
+#include "e/static_packer.h"
+
+// bench
+#include "bench/bench.h"
+
+namespace
+{
+
+const size_t ROUNDS = 10000;
+const size_t MESSAGES = 100;
+const size_t MESSAGE_SIZE = 8 + 4 + 2 + 1 + 17;
+
+struct message
+{
+	message(uint64_t r, size_t i, const e::slice &k)
+		: round(r), index(i), a(i), b(i), key(k) {}
+
+	uint64_t round;
+	uint32_t index;
+	uint16_t a;
+	uint8_t b;
+	e::slice key;
+};
+
+e::packer
+operator << (e::packer pa, const message &m)
+{
+	return pa << m.round << m.index << m.a << m.b << m.key;
+}
+
+double
+dynamic(e::buffer *buf)
+{
+	const e::slice key("0123456789abcdef", 16);
+	const uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		e::packer pa = buf->pack_at(0);
+
+		for (size_t i = 0; i < MESSAGES; ++i)
+		{
+			pa = pa << uint64_t(r) << uint32_t(i) << uint16_t(i) << uint8_t(i) << key;
+		}
+
+		bench::use(buf->data());
+	}
+
+	const uint64_t end = bench::now();
+	return (ROUNDS * MESSAGES) / ((end - start) / 1e9);
+}
+
+double
+statik(e::buffer *buf)
+{
+	const e::slice key("0123456789abcdef", 16);
+	e::buffer_sink sink(buf);
+	const uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		e::static_packer<e::buffer_sink> pa(&sink);
+
+		for (size_t i = 0; i < MESSAGES; ++i)
+		{
+			pa = pa << uint64_t(r) << uint32_t(i) << uint16_t(i) << uint8_t(i) << key;
+		}
+
+		bench::use(buf->data());
+	}
+
+	const uint64_t end = bench::now();
+	return (ROUNDS * MESSAGES) / ((end - start) / 1e9);
+}
+
+double
+dynamic_struct(e::buffer *buf)
+{
+	const e::slice key("0123456789abcdef", 16);
+	const uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		e::packer pa = buf->pack_at(0);
+
+		for (size_t i = 0; i < MESSAGES; ++i)
+		{
+			pa = pa << message(r, i, key);
+		}
+
+		bench::use(buf->data());
+	}
+
+	const uint64_t end = bench::now();
+	return (ROUNDS * MESSAGES) / ((end - start) / 1e9);
+}
+
+double
+static_struct(e::buffer *buf)
+{
+	const e::slice key("0123456789abcdef", 16);
+	e::buffer_sink sink(buf);
+	const uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		e::static_packer<e::buffer_sink> pa(&sink);
+
+		for (size_t i = 0; i < MESSAGES; ++i)
+		{
+			pa = pa << message(r, i, key);
+		}
+
+		bench::use(buf->data());
+	}
+
+	const uint64_t end = bench::now();
+	return (ROUNDS * MESSAGES) / ((end - start) / 1e9);
+}
+
+} // namespace
+
+int
+main(int, const char *[])
+{
+	std::auto_ptr<e::buffer> buf(e::buffer::create(MESSAGES * MESSAGE_SIZE));
+	std::cout << "e::packer:        " << dynamic(buf.get()) << " messages/s" << std::endl;
+	std::cout << "e::static_packer: " << statik(buf.get()) << " messages/s" << std::endl;
+	std::cout << "e::packer, struct:        " << dynamic_struct(buf.get()) << " messages/s" << std::endl;
+	std::cout << "e::static_packer, struct: " << static_struct(buf.get()) << " messages/s" << std::endl;
+	return EXIT_SUCCESS;
+}
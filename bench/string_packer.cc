@@ -0,0 +1,82 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Pack 100k records into one std::string, each with a length header that
+// is back-patched once the record's body has been packed.
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <iostream>
+#include <string>
+
+// e
+#include "e/serialization.h"
+
+// bench
+#include "bench/bench.h"
+
+namespace
+{
+
+const size_t RECORDS = 100000;
+const size_t ROUNDS = 10;
+
+} // namespace
+
+int
+main(int, const char *[])
+{
+	const e::slice body("0123456789abcdef0123456789abcdef", 32);
+	size_t total = 0;
+	const uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		std::string s;
+		e::packer pa(&s);
+
+		for (size_t i = 0; i < RECORDS; ++i)
+		{
+			e::packer header = pa;
+			pa = pa << uint32_t(0) << uint64_t(i) << body;
+			header << uint32_t(pa.offset() - header.offset());
+		}
+
+		total += s.size();
+		bench::use(s.data());
+	}
+
+	const uint64_t end = bench::now();
+	const double secs = (end - start) / 1e9;
+	std::cout << (ROUNDS * RECORDS) / secs << " records/s, "
+	          << total / secs / 1e6 << " MB/s" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Encode 1M varint64s of mixed lengths one at a time (the per-value loop
+// that sizes and encodes each value) and with varint_length_n and
+// varint64_encode_n, which size the output once and then fill it.
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <iostream>
+#include <vector>
+
+// e
+#include "e/varint.h"
+
+// bench
+#include "bench/bench.h"
+
+namespace
+{
+
+const size_t VALUES = 1000000;
+const size_t ROUNDS = 20;
+
+// varint_length as a loop over 7-bit groups
+int
+loop_length(uint64_t v)
+{
+	int len = 1;
+
+	while (v >= 128)
+	{
+		v >>= 7;
+		len++;
+	}
+
+	return len;
+}
+
+void
+report(const char *name, uint64_t start, uint64_t end)
+{
+	const double secs = (end - start) / 1e9;
+	std::cout << name << ": " << (ROUNDS * VALUES) / secs / 1e6
+	          << "M values/s" << std::endl;
+}
+
+} // namespace
+
+int
+main(int, const char *[])
+{
+	std::vector<uint64_t> values(VALUES);
+	uint64_t seed = 0x9e3779b97f4a7c15ULL;
+
+	// mostly small, with a long tail: shift a random number by 0-63 bits
+	for (size_t i = 0; i < VALUES; ++i)
+	{
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		values[i] = seed >> (seed & 63);
+	}
+
+	std::vector<char> out(VALUES * 10);
+	uint64_t start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		size_t sz = 0;
+
+		for (size_t i = 0; i < VALUES; ++i)
+		{
+			sz += loop_length(values[i]);
+		}
+
+		char *ptr = &out[0];
+
+		for (size_t i = 0; i < VALUES; ++i)
+		{
+			ptr = e::varint64_encode(ptr, values[i]);
+		}
+
+		bench::use(sz);
+		bench::use(ptr);
+	}
+
+	report("per-value", start, bench::now());
+	start = bench::now();
+
+	for (size_t r = 0; r < ROUNDS; ++r)
+	{
+		const size_t sz = e::varint_length_n(&values[0], VALUES);
+		char *ptr = e::varint64_encode_n(&out[0], &values[0], VALUES);
+		bench::use(sz);
+		bench::use(ptr);
+	}
+
+	report("bulk", start, bench::now());
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,196 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <string.h>
+
+// e
+#include "bswap.h"
+
+#ifdef E_BSWAP_X86
+#include <immintrin.h>
+#endif
+
+void
+e :: bswap32_scalar(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		uint32_t x;
+		memcpy(&x, src + i * 4, 4);
+		x = __builtin_bswap32(x);
+		memcpy(dst + i * 4, &x, 4);
+	}
+}
+
+void
+e :: bswap64_scalar(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		uint64_t x;
+		memcpy(&x, src + i * 8, 8);
+		x = __builtin_bswap64(x);
+		memcpy(dst + i * 8, &x, 8);
+	}
+}
+
+#ifdef E_BSWAP_X86
+
+__attribute__ ((target ("ssse3")))
+void
+e :: bswap32_ssse3(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	const __m128i mask = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+	                                  4, 5, 6, 7, 0, 1, 2, 3);
+	size_t i = 0;
+
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_shuffle_epi8(x, mask));
+	}
+
+	bswap32_scalar(src + i * 4, n - i, dst + i * 4);
+}
+
+__attribute__ ((target ("ssse3")))
+void
+e :: bswap64_ssse3(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	const __m128i mask = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+	                                  0, 1, 2, 3, 4, 5, 6, 7);
+	size_t i = 0;
+
+	for (; i + 2 <= n; i += 2)
+	{
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 8), _mm_shuffle_epi8(x, mask));
+	}
+
+	bswap64_scalar(src + i * 8, n - i, dst + i * 8);
+}
+
+__attribute__ ((target ("avx2")))
+void
+e :: bswap32_avx2(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	const __m256i mask = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+	                                     4, 5, 6, 7, 0, 1, 2, 3,
+	                                     12, 13, 14, 15, 8, 9, 10, 11,
+	                                     4, 5, 6, 7, 0, 1, 2, 3);
+	size_t i = 0;
+
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), _mm256_shuffle_epi8(x, mask));
+	}
+
+	bswap32_scalar(src + i * 4, n - i, dst + i * 4);
+}
+
+__attribute__ ((target ("avx2")))
+void
+e :: bswap64_avx2(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	const __m256i mask = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+	                                     0, 1, 2, 3, 4, 5, 6, 7,
+	                                     8, 9, 10, 11, 12, 13, 14, 15,
+	                                     0, 1, 2, 3, 4, 5, 6, 7);
+	size_t i = 0;
+
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 8));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 8), _mm256_shuffle_epi8(x, mask));
+	}
+
+	bswap64_scalar(src + i * 8, n - i, dst + i * 8);
+}
+
+#endif // E_BSWAP_X86
+
+namespace
+{
+
+// Every kernel swaps bytes within "width"-byte words, so one routine per
+// width serves both directions.
+typedef void (*swap_kernel)(const uint8_t *src, size_t n, uint8_t *dst);
+
+struct kernels
+{
+	swap_kernel swap32;
+	swap_kernel swap64;
+};
+
+kernels
+choose_kernels()
+{
+	kernels k;
+	k.swap32 = e::bswap32_scalar;
+	k.swap64 = e::bswap64_scalar;
+#ifdef E_BSWAP_X86
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2"))
+	{
+		k.swap32 = e::bswap32_avx2;
+		k.swap64 = e::bswap64_avx2;
+	}
+	else if (__builtin_cpu_supports("ssse3"))
+	{
+		k.swap32 = e::bswap32_ssse3;
+		k.swap64 = e::bswap64_ssse3;
+	}
+#endif // E_BSWAP_X86
+	return k;
+}
+
+// A function-local static rather than a file-scope initializer, so bulk
+// packing run from other static initializers already gets the fast path.
+const kernels &
+select_kernels()
+{
+	static const kernels k = choose_kernels();
+	return k;
+}
+
+} // namespace
+
+void
+e :: bswap32_n(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	select_kernels().swap32(src, n, dst);
+}
+
+void
+e :: bswap64_n(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	select_kernels().swap64(src, n, dst);
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_bswap_h_
+#define e_bswap_h_
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define E_BSWAP_X86 1
+#endif
+
+namespace e
+{
+
+// Reverse the bytes of each of "n" 4- or 8-byte words from "src" into "dst".
+// Neither pointer needs to be aligned; the ranges must not overlap.  These
+// pick SSSE3 or AVX2 kernels on first use where available, and back the
+// bulk functions in e/endian.h.
+void bswap32_n(const uint8_t *src, size_t n, uint8_t *dst);
+void bswap64_n(const uint8_t *src, size_t n, uint8_t *dst);
+
+// The individual kernels, so that tests can check them against each other.
+// The SIMD ones may only be called when the CPU supports them.
+void bswap32_scalar(const uint8_t *src, size_t n, uint8_t *dst);
+void bswap64_scalar(const uint8_t *src, size_t n, uint8_t *dst);
+#ifdef E_BSWAP_X86
+void bswap32_ssse3(const uint8_t *src, size_t n, uint8_t *dst);
+void bswap64_ssse3(const uint8_t *src, size_t n, uint8_t *dst);
+void bswap32_avx2(const uint8_t *src, size_t n, uint8_t *dst);
+void bswap64_avx2(const uint8_t *src, size_t n, uint8_t *dst);
+#endif // E_BSWAP_X86
+
+} // namespace e
+
+#endif // e_bswap_h_
@@ -29,17 +29,41 @@
 #include <stddef.h>
 
 // STL
+#include <algorithm>
 #include <memory>
+#include <new>
 
 // e
+#include "e/arena.h"
 #include "e/buffer.h"
 
 using e::buffer;
 
+size_t
+buffer :: footprint(size_t num)
+{
+	// never less than sizeof(buffer), because m_data always has one element
+	return std::max(sizeof(buffer), offsetof(buffer, m_data) + num);
+}
+
 void *
 buffer :: operator new (size_t, size_t num)
 {
-	return new char[offsetof(buffer, m_data) + num];
+	return new char[footprint(num)];
+}
+
+void *
+buffer :: operator new (size_t, e::arena *a, size_t num)
+{
+	unsigned char *ptr = NULL;
+	a->allocate(footprint(num), __alignof__(buffer), &ptr);
+
+	if (!ptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
 }
 
 void
@@ -83,7 +107,7 @@ buffer :: copy() const
 	std::auto_ptr<buffer> ret(create(m_cap));
 	ret->m_cap = m_cap;
 	ret->m_size = m_size;
-	memmove(ret->m_data, m_data, m_cap);
+	memmove(ret->m_data, m_data, m_size);
 	return ret.release();
 }
 
@@ -0,0 +1,469 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include "e/buffer_chain.h"
+#include "e/varint.h"
+
+using e::buffer_chain;
+using e::chain_unpacker;
+
+namespace
+{
+
+const size_t TAIL_SIZE = 4096;
+const size_t MAX_IOVECS = 64;
+
+} // namespace
+
+class buffer_chain::bytes_manager : public e::packer::bytes_manager
+{
+public:
+	bytes_manager(buffer_chain *chain) : m_chain(chain) {}
+	virtual ~bytes_manager() throw () {}
+
+public:
+	virtual void write(size_t off, const uint8_t *ptr, size_t ptr_sz);
+	virtual void reference(size_t off, const uint8_t *ptr, size_t ptr_sz);
+
+private:
+	buffer_chain *m_chain;
+
+private:
+	bytes_manager(const bytes_manager &);
+	bytes_manager &operator = (const bytes_manager &);
+};
+
+void
+buffer_chain :: bytes_manager :: write(size_t off, const uint8_t *ptr, size_t ptr_sz)
+{
+	if (off < m_chain->m_consumed)
+	{
+		abort();
+	}
+
+	off -= m_chain->m_consumed;
+
+	while (m_chain->m_size < off)
+	{
+		static const uint8_t zeros[64] = {0};
+		m_chain->copy(zeros, std::min(sizeof(zeros), off - m_chain->m_size));
+	}
+
+	const size_t overlap = std::min(ptr_sz, m_chain->m_size - off);
+	m_chain->patch(off, ptr, overlap);
+	m_chain->copy(ptr + overlap, ptr_sz - overlap);
+}
+
+void
+buffer_chain :: bytes_manager :: reference(size_t off, const uint8_t *ptr, size_t ptr_sz)
+{
+	if (ptr_sz >= m_chain->m_reference_threshold &&
+	    off == m_chain->m_consumed + m_chain->m_size)
+	{
+		m_chain->push(ptr, ptr_sz, false);
+	}
+	else
+	{
+		write(off, ptr, ptr_sz);
+	}
+}
+
+buffer_chain :: buffer_chain()
+	: m_reference_threshold(DEFAULT_REFERENCE_THRESHOLD)
+	, m_segments()
+	, m_head(0)
+	, m_size(0)
+	, m_consumed(0)
+	, m_tail(NULL)
+	, m_owned()
+	, m_shared()
+{
+}
+
+buffer_chain :: buffer_chain(size_t reference_threshold)
+	: m_reference_threshold(reference_threshold)
+	, m_segments()
+	, m_head(0)
+	, m_size(0)
+	, m_consumed(0)
+	, m_tail(NULL)
+	, m_owned()
+	, m_shared()
+{
+}
+
+buffer_chain :: ~buffer_chain() throw ()
+{
+	clear();
+}
+
+e::slice
+buffer_chain :: segment(size_t idx) const
+{
+	assert(m_head + idx < m_segments.size());
+	const struct region &s(m_segments[m_head + idx]);
+	return e::slice(s.data, s.size);
+}
+
+e::packer
+buffer_chain :: pack()
+{
+	e::compat::shared_ptr<e::packer::bytes_manager> mgr(new bytes_manager(this));
+	return e::packer(mgr, m_consumed + m_size);
+}
+
+void
+buffer_chain :: copy(const e::slice &s)
+{
+	copy(s.data(), s.size());
+}
+
+void
+buffer_chain :: reference(const e::slice &s)
+{
+	push(s.data(), s.size(), false);
+}
+
+void
+buffer_chain :: append(e::buffer *buf)
+{
+	m_owned.push_back(buf);
+	push(buf->data(), buf->size(), false);
+}
+
+void
+buffer_chain :: append(const e::shared_slice &s)
+{
+	m_shared.push_back(s.owner());
+	push(s.data(), s.size(), false);
+}
+
+size_t
+buffer_chain :: iovecs(struct iovec *iov, size_t iovcnt) const
+{
+	size_t i = 0;
+
+	for (size_t s = m_head; s < m_segments.size() && i < iovcnt; ++s, ++i)
+	{
+		iov[i].iov_base = const_cast<uint8_t *>(m_segments[s].data);
+		iov[i].iov_len = m_segments[s].size;
+	}
+
+	return i;
+}
+
+ssize_t
+buffer_chain :: writev(int fd)
+{
+	struct iovec iov[MAX_IOVECS];
+	const size_t iovcnt = iovecs(iov, MAX_IOVECS);
+	const ssize_t ret = ::writev(fd, iov, iovcnt);
+
+	if (ret > 0)
+	{
+		consume(ret);
+	}
+
+	return ret;
+}
+
+void
+buffer_chain :: consume(size_t sz)
+{
+	assert(sz <= m_size);
+	m_size -= sz;
+	m_consumed += sz;
+
+	while (sz > 0)
+	{
+		struct region &s(m_segments[m_head]);
+		const size_t x = std::min(sz, s.size);
+		s.data += x;
+		s.size -= x;
+		sz -= x;
+
+		if (s.size == 0)
+		{
+			++m_head;
+		}
+	}
+
+	if (m_head == m_segments.size())
+	{
+		const size_t consumed = m_consumed;
+		clear();
+		m_consumed = consumed;
+	}
+}
+
+e::buffer *
+buffer_chain :: coalesce() const
+{
+	e::buffer *buf = e::buffer::create(m_size);
+
+	for (size_t s = m_head; s < m_segments.size(); ++s)
+	{
+		memmove(buf->end(), m_segments[s].data, m_segments[s].size);
+		buf->resize(buf->size() + m_segments[s].size);
+	}
+
+	return buf;
+}
+
+void
+buffer_chain :: clear()
+{
+	for (size_t i = 0; i < m_owned.size(); ++i)
+	{
+		delete m_owned[i];
+	}
+
+	m_segments.clear();
+	m_head = 0;
+	m_size = 0;
+	m_consumed = 0;
+	m_tail = NULL;
+	m_owned.clear();
+	m_shared.clear();
+}
+
+void
+buffer_chain :: copy(const uint8_t *ptr, size_t sz)
+{
+	while (sz > 0)
+	{
+		if (!m_tail || m_tail->size() == m_tail->capacity())
+		{
+			m_tail = e::buffer::create(std::max(TAIL_SIZE, sz));
+			m_owned.push_back(m_tail);
+		}
+
+		const size_t x = std::min(sz, m_tail->capacity() - m_tail->size());
+		uint8_t *dst = m_tail->end();
+		memmove(dst, ptr, x);
+		m_tail->resize(m_tail->size() + x);
+		push(dst, x, true);
+		ptr += x;
+		sz -= x;
+	}
+}
+
+void
+buffer_chain :: patch(size_t off, const uint8_t *ptr, size_t sz)
+{
+	for (size_t s = m_head; s < m_segments.size() && sz > 0; ++s)
+	{
+		const struct region &seg(m_segments[s]);
+
+		if (off >= seg.size)
+		{
+			off -= seg.size;
+			continue;
+		}
+
+		if (!seg.writable)
+		{
+			abort();
+		}
+
+		const size_t x = std::min(sz, seg.size - off);
+		memmove(const_cast<uint8_t *>(seg.data) + off, ptr, x);
+		ptr += x;
+		sz -= x;
+		off = 0;
+	}
+}
+
+void
+buffer_chain :: push(const uint8_t *ptr, size_t sz, bool writable)
+{
+	if (sz == 0)
+	{
+		return;
+	}
+
+	if (m_segments.size() > m_head)
+	{
+		struct region &last(m_segments.back());
+
+		if (last.writable == writable && last.data + last.size == ptr)
+		{
+			last.size += sz;
+			m_size += sz;
+			return;
+		}
+	}
+
+	m_segments.push_back(region(ptr, sz, writable));
+	m_size += sz;
+}
+
+chain_unpacker :: chain_unpacker(const buffer_chain &chain)
+	: m_segments()
+	, m_seg(0)
+	, m_off(0)
+	, m_remain(chain.size())
+	, m_window(NULL)
+	, m_scratch()
+	, m_error(false)
+{
+	for (size_t i = 0; i < chain.segment_count(); ++i)
+	{
+		m_segments.push_back(chain.segment(i));
+	}
+}
+
+chain_unpacker :: chain_unpacker(const std::vector<e::slice> &segments)
+	: m_segments(segments)
+	, m_seg(0)
+	, m_off(0)
+	, m_remain(0)
+	, m_window(NULL)
+	, m_scratch()
+	, m_error(false)
+{
+	for (size_t i = 0; i < m_segments.size(); ++i)
+	{
+		m_remain += m_segments[i].size();
+	}
+
+	consume(0);
+}
+
+chain_unpacker :: ~chain_unpacker() throw ()
+{
+	delete m_window;
+
+	for (size_t i = 0; i < m_scratch.size(); ++i)
+	{
+		delete m_scratch[i];
+	}
+}
+
+e::slice
+chain_unpacker :: window() const
+{
+	if (m_window)
+	{
+		return m_window->as_slice();
+	}
+
+	if (m_seg >= m_segments.size())
+	{
+		return e::slice();
+	}
+
+	const e::slice &s(m_segments[m_seg]);
+	return e::slice(s.data() + m_off, s.size() - m_off);
+}
+
+void
+chain_unpacker :: widen(size_t sz)
+{
+	// Callers at least double the window between calls, so copying it
+	// afresh keeps the total copied proportional to the value's size.
+	assert(sz <= m_remain);
+	e::buffer *buf = e::buffer::create(sz);
+	buf->resize(copy(buf->data(), sz));
+	delete m_window;
+	m_window = buf;
+}
+
+void
+chain_unpacker :: consume(size_t sz)
+{
+	assert(sz <= m_remain);
+	m_remain -= sz;
+
+	if (m_window)
+	{
+		// slices decoded from the window may point into it
+		m_scratch.push_back(m_window);
+		m_window = NULL;
+	}
+
+	m_off += sz;
+
+	while (m_seg < m_segments.size() && m_off >= m_segments[m_seg].size())
+	{
+		m_off -= m_segments[m_seg].size();
+		++m_seg;
+	}
+}
+
+size_t
+chain_unpacker :: copy(uint8_t *dst, size_t sz) const
+{
+	size_t seg = m_seg;
+	size_t off = m_off;
+	size_t done = 0;
+
+	while (done < sz && seg < m_segments.size())
+	{
+		const e::slice &s(m_segments[seg]);
+		const size_t n = std::min(sz - done, s.size() - off);
+		memmove(dst + done, s.data() + off, n);
+		done += n;
+		off = 0;
+		++seg;
+	}
+
+	return done;
+}
+
+size_t
+chain_unpacker :: prefixed(size_t elem) const
+{
+	uint8_t buf[VARINT_64_MAX_SIZE];
+	const size_t sz = copy(buf, sizeof(buf));
+	uint64_t n = 0;
+	const uint8_t *ptr = e::varint64_decode(buf, buf + sz, &n);
+
+	if (!ptr)
+	{
+		return static_cast<size_t>(-1);
+	}
+
+	const size_t len = ptr - buf;
+
+	if (n > (m_remain - len) / elem)
+	{
+		return static_cast<size_t>(-1);
+	}
+
+	return len + n * elem;
+}
@@ -29,45 +29,231 @@
 #define e_arena_h_
 
 // C
+#include <stdint.h>
 #include <stdlib.h>
 
+// C++
+#include <new>
+
 // STL
 #include <vector>
 
 namespace e
 {
+class arena_chunk_source;
 class buffer;
 
+// A bump-pointer allocator for objects that share a lifetime.  Memory is
+// carved out of chunks that grow geometrically from "initial_chunk" up to
+// "max_chunk" bytes; requests too large to share a chunk get their own
+// allocation.  A "max_chunk" of zero disables chunking so that every request
+// that does not fit in the last reserve()d region is a separate malloc.
+//
+// Chunks come from malloc unless the arena is given a non-NULL
+// arena_chunk_source, which must outlive the arena.
 class arena
 {
+public:
+	static const size_t DEFAULT_INITIAL_CHUNK = 4096;
+	static const size_t DEFAULT_MAX_CHUNK = 1048576;
+
 public:
 	arena();
+	arena(size_t initial_chunk, size_t max_chunk);
+	arena(size_t initial_chunk, size_t max_chunk, arena_chunk_source *source);
 	~arena();
 
 public:
 	void reserve(size_t sz);
 	void allocate(size_t sz, char **ptr);
 	void allocate(size_t sz, unsigned char **ptr);
+	// "align" must be a power of two
+	void allocate(size_t sz, size_t align, unsigned char **ptr);
 	void takeover(char *ptr);
 	void takeover(unsigned char *ptr);
 	void takeover(void *ptr);
 	void takeover(e::buffer *buf);
 	void clear();
+	// Like clear(), but hold on to chunks (largest first) totalling at most
+	// "retain" bytes and serve the next allocations from them.  reset() with
+	// no argument keeps only the largest chunk.
+	void reset();
+	void reset(size_t retain);
+	// Bytes held in chunks, including chunks retained across reset().
+	size_t retained() const { return m_chunk_bytes; }
+
+public:
+	struct stats
+	{
+		stats();
+		uint64_t bytes_reserved; // held in chunks and dedicated allocations
+		uint64_t bytes_used; // handed out by allocate since the last reset
+		uint64_t chunks; // chunks allocated
+		uint64_t fallbacks; // requests that got an allocation of their own
+		uint64_t takeovers; // pointers and buffers taken over
+		uint64_t peak_reserved; // high-water mark of bytes_reserved
+		uint64_t peak_used; // high-water mark of bytes_used
+	};
+	void statistics(stats *s) const;
+	// Totals over every arena in the process.  bytes_reserved covers live
+	// arenas; bytes_used, chunks, fallbacks and takeovers are cumulative, and
+	// the usage and takeovers of an arena are added when it is reset.
+	static void global_statistics(stats *s);
+
+public:
+	// Uninitialized storage for "n" objects of type T, suitably aligned.
+	template <typename T> T *allocate(size_t n);
+	// Construct a T inside the arena.  Its destructor runs on clear() or
+	// when the arena is destroyed, in reverse order of construction.
+	template <typename T> T *construct();
+	template <typename T, typename A1> T *construct(const A1 &a1);
+	template <typename T, typename A1, typename A2>
+	T *construct(const A1 &a1, const A2 &a2);
+	template <typename T, typename A1, typename A2, typename A3>
+	T *construct(const A1 &a1, const A2 &a2, const A3 &a3);
+	template <typename T, typename A1, typename A2, typename A3, typename A4>
+	T *construct(const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4);
+
+private:
+	struct chunk
+	{
+		chunk() : base(NULL), size(0) {}
+		chunk(unsigned char *b, size_t s) : base(b), size(s) {}
+		static bool larger(const chunk &lhs, const chunk &rhs) { return lhs.size > rhs.size; }
+		unsigned char *base;
+		size_t size;
+	};
+	struct destructor
+	{
+		destructor() : func(NULL), obj(NULL) {}
+		destructor(void (*f)(void *), void *o) : func(f), obj(o) {}
+		void (*func)(void *);
+		void *obj;
+	};
+	template <typename T> static void destroy(void *obj) { static_cast<T *>(obj)->~T(); }
+	template <typename T> void *prepare(size_t *idx);
+	template <typename T> T *finish(size_t idx, T *t);
+	void run_destructors();
 
 private:
 	arena(const arena &);
 	arena &operator = (const arena &);
 
 private:
+	bool take_spare(size_t sz);
+	void new_chunk(size_t sz);
 	void raw_allocate(size_t sz, unsigned char **ptr);
+	unsigned char *source_allocate(size_t *sz);
+	void source_deallocate(unsigned char *ptr, size_t sz);
+	void account(size_t sz, uint64_t *counter);
 
 private:
 	std::vector<unsigned char *> m_to_free;
 	std::vector<e::buffer *> m_buffers;
+	std::vector<destructor> m_destructors;
+	std::vector<chunk> m_chunks; // every chunk owned by the arena
+	std::vector<chunk> m_spare; // retained chunks that are not yet in use
+	std::vector<chunk> m_large; // dedicated allocations for large requests
+	arena_chunk_source *m_source;
+	size_t m_chunk_bytes;
 	unsigned char *m_start;
 	unsigned char *m_limit;
+	size_t m_next_chunk;
+	size_t m_max_chunk;
+	uint64_t m_used;
+	uint64_t m_fallback_bytes;
+	uint64_t m_chunk_count;
+	uint64_t m_fallbacks;
+	uint64_t m_takeovers;
+	uint64_t m_peak_reserved;
+	uint64_t m_peak_used;
+	uint64_t m_takeovers_reported;
 };
 
+template <typename T>
+T *
+arena :: allocate(size_t n)
+{
+	if (n > static_cast<size_t>(-1) / sizeof(T))
+	{
+		return NULL;
+	}
+	unsigned char *ptr = NULL;
+	allocate(n * sizeof(T), __alignof__(T), &ptr);
+	return reinterpret_cast<T *>(ptr);
+}
+
+// Reserve the destructor slot before constructing so that registering it
+// cannot fail after the object exists.  A slot whose constructor threw keeps
+// a NULL func and is skipped.
+template <typename T>
+void *
+arena :: prepare(size_t *idx)
+{
+	unsigned char *ptr = NULL;
+	allocate(sizeof(T), __alignof__(T), &ptr);
+	if (!ptr)
+	{
+		return NULL;
+	}
+	*idx = m_destructors.size();
+	m_destructors.push_back(destructor());
+	return ptr;
+}
+
+template <typename T>
+T *
+arena :: finish(size_t idx, T *t)
+{
+	m_destructors[idx] = destructor(&destroy<T>, t);
+	return t;
+}
+
+template <typename T>
+T *
+arena :: construct()
+{
+	size_t idx;
+	void *mem = prepare<T>(&idx);
+	return mem ? finish(idx, new (mem) T()) : NULL;
+}
+
+template <typename T, typename A1>
+T *
+arena :: construct(const A1 &a1)
+{
+	size_t idx;
+	void *mem = prepare<T>(&idx);
+	return mem ? finish(idx, new (mem) T(a1)) : NULL;
+}
+
+template <typename T, typename A1, typename A2>
+T *
+arena :: construct(const A1 &a1, const A2 &a2)
+{
+	size_t idx;
+	void *mem = prepare<T>(&idx);
+	return mem ? finish(idx, new (mem) T(a1, a2)) : NULL;
+}
+
+template <typename T, typename A1, typename A2, typename A3>
+T *
+arena :: construct(const A1 &a1, const A2 &a2, const A3 &a3)
+{
+	size_t idx;
+	void *mem = prepare<T>(&idx);
+	return mem ? finish(idx, new (mem) T(a1, a2, a3)) : NULL;
+}
+
+template <typename T, typename A1, typename A2, typename A3, typename A4>
+T *
+arena :: construct(const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4)
+{
+	size_t idx;
+	void *mem = prepare<T>(&idx);
+	return mem ? finish(idx, new (mem) T(a1, a2, a3, a4)) : NULL;
+}
+
 } // namespace e
 
 #endif // e_arena_h_
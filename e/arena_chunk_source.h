@@ -0,0 +1,83 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_arena_chunk_source_h_
+#define e_arena_chunk_source_h_
+
+// C
+#include <stdlib.h>
+
+namespace e
+{
+
+// Where an e::arena gets its chunks and its allocations for large requests.
+class arena_chunk_source
+{
+public:
+	arena_chunk_source();
+	virtual ~arena_chunk_source() throw ();
+
+public:
+	// Return at least *sz bytes, updating *sz if the request was rounded up,
+	// or NULL on failure.
+	virtual unsigned char *allocate(size_t *sz) = 0;
+	virtual void deallocate(unsigned char *ptr, size_t sz) = 0;
+	// Called on chunks that an arena keeps across reset(); their contents
+	// need not be preserved.
+	virtual void recycle(unsigned char *ptr, size_t sz);
+
+private:
+	arena_chunk_source(const arena_chunk_source &);
+	arena_chunk_source &operator = (const arena_chunk_source &);
+};
+
+// Map chunks directly with mmap and return them with munmap.  With
+// "huge_pages", chunks are rounded to and aligned on 2MB boundaries and the
+// kernel is asked to back them with transparent huge pages.  With
+// "release_on_reset", chunks kept across arena::reset() give their pages back
+// with MADV_DONTNEED; they read as zero when next touched.
+class mmap_chunk_source : public arena_chunk_source
+{
+public:
+	mmap_chunk_source(bool huge_pages, bool release_on_reset);
+	virtual ~mmap_chunk_source() throw ();
+
+public:
+	virtual unsigned char *allocate(size_t *sz);
+	virtual void deallocate(unsigned char *ptr, size_t sz);
+	virtual void recycle(unsigned char *ptr, size_t sz);
+
+private:
+	const bool m_huge_pages;
+	const bool m_release_on_reset;
+	const size_t m_granularity;
+};
+
+} // namespace e
+
+#endif // e_arena_chunk_source_h_
@@ -0,0 +1,108 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_arena_pool_h_
+#define e_arena_pool_h_
+
+// C
+#include <pthread.h>
+#include <stdint.h>
+
+// STL
+#include <vector>
+
+// po6
+#include <po6/threads/mutex.h>
+
+// e
+#include <e/arena.h>
+
+namespace e
+{
+
+// Hand out arenas that keep their chunks from one use to the next.  Each
+// thread has a small cache of arenas; arenas that do not fit in the cache of
+// the thread releasing them go to a list shared by all threads.  An arena may
+// be released by a different thread than the one that acquired it.
+//
+// The pool must outlive every thread that uses it.
+class arena_pool
+{
+public:
+	// Each thread caches up to "per_thread" arenas.  Released arenas keep
+	// up to "retain" bytes of chunks, or their largest chunk if "retain" is 0.
+	arena_pool();
+	arena_pool(size_t per_thread, size_t retain);
+	// Arenas the pool creates use these chunk sizes and take chunks from
+	// "source" (which may be NULL, and must otherwise outlive the pool).  Each
+	// starts with "prewarm" bytes already reserved, so that its first use
+	// does not pay for its first chunk.
+	arena_pool(size_t per_thread, size_t retain,
+	           size_t initial_chunk, size_t max_chunk,
+	           arena_chunk_source *source, size_t prewarm);
+	~arena_pool() throw ();
+
+public:
+	arena *acquire();
+	void release(arena *a);
+
+public:
+	uint64_t hits() const;
+	uint64_t misses() const;
+	uint64_t retained_bytes() const;
+
+private:
+	struct thread_cache;
+	static void thread_exit(void *tc);
+	thread_cache *get_cache();
+	arena *create();
+	void account(arena *a, bool add);
+
+private:
+	pthread_key_t m_key;
+	const size_t m_per_thread;
+	const size_t m_retain;
+	const size_t m_initial_chunk;
+	const size_t m_max_chunk;
+	arena_chunk_source *const m_source;
+	const size_t m_prewarm;
+	po6::threads::mutex m_mtx;
+	std::vector<arena *> m_shared;
+	std::vector<thread_cache *> m_caches;
+	uint64_t m_hits;
+	uint64_t m_misses;
+	uint64_t m_retained;
+
+private:
+	arena_pool(const arena_pool &);
+	arena_pool &operator = (const arena_pool &);
+};
+
+} // namespace e
+
+#endif // e_arena_pool_h_
@@ -40,12 +40,17 @@
 
 namespace e
 {
+class arena;
 
 class buffer
 {
 public:
 	static buffer *create(size_t sz) { return new (sz) buffer(sz); }
 	static buffer *create(const char *buf, size_t sz) { return new (sz) buffer(buf, sz); }
+	// Place the buffer inside "a".  It is released along with the arena's
+	// memory and must never be deleted or passed to arena::takeover.
+	static buffer *create(e::arena *a, size_t sz) { return new (a, sz) buffer(sz); }
+	static buffer *create(e::arena *a, const char *buf, size_t sz) { return new (a, sz) buffer(buf, sz); }
 
 public:
 	void operator delete (void *mem);
@@ -77,7 +82,9 @@ public:
 	e::unpacker unpack_from(size_t off);
 
 private:
+	static size_t footprint(size_t num);
 	void *operator new (size_t sz, size_t num);
+	void *operator new (size_t sz, e::arena *a, size_t num);
 	buffer(size_t sz);
 	buffer(const char *buf, size_t sz);
 
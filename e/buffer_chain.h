@@ -0,0 +1,233 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_buffer_chain_h_
+#define e_buffer_chain_h_
+
+// C
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+// STL
+#include <algorithm>
+#include <list>
+#include <vector>
+
+// e
+#include <e/buffer.h>
+#include <e/serialization.h>
+#include <e/shared_buffer.h>
+#include <e/slice.h>
+
+namespace e
+{
+
+// A sequence of byte segments that is written out with writev instead of
+// being concatenated first.  Small writes are copied into chunks the chain
+// owns; large e::slices packed through pack(), and anything passed to
+// reference(), are referenced in place and must outlive the chain.
+class buffer_chain
+{
+public:
+	static const size_t DEFAULT_REFERENCE_THRESHOLD = 512;
+
+public:
+	buffer_chain();
+	buffer_chain(size_t reference_threshold);
+	~buffer_chain() throw ();
+
+public:
+	size_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+	size_t segment_count() const { return m_segments.size() - m_head; }
+	e::slice segment(size_t idx) const;
+
+public:
+	// Packers append to the end of the chain and may back-patch bytes that
+	// were copied (not referenced).  The chain must outlive them.
+	e::packer pack();
+	void copy(const e::slice &s);
+	void reference(const e::slice &s);
+	// Take ownership of a heap buffer without copying it.
+	void append(e::buffer *buf);
+	void append(const e::shared_slice &s);
+	// Fill at most iovcnt entries from the front of the chain and return the
+	// number filled.
+	size_t iovecs(struct iovec *iov, size_t iovcnt) const;
+	// One writev(2) call; bytes written are consumed.
+	ssize_t writev(int fd);
+	// Drop sz bytes from the front of the chain.
+	void consume(size_t sz);
+	// The whole chain as one contiguous heap buffer owned by the caller.
+	e::buffer *coalesce() const;
+	void clear();
+
+private:
+	struct region;
+	class bytes_manager;
+	friend class bytes_manager;
+	void copy(const uint8_t *ptr, size_t sz);
+	void patch(size_t off, const uint8_t *ptr, size_t sz);
+	void push(const uint8_t *ptr, size_t sz, bool writable);
+
+private:
+	const size_t m_reference_threshold;
+	std::vector<region> m_segments;
+	size_t m_head;
+	size_t m_size;
+	size_t m_consumed;
+	e::buffer *m_tail;
+	std::vector<e::buffer *> m_owned;
+	std::vector<e::shared_buffer::ref> m_shared;
+
+private:
+	buffer_chain(const buffer_chain &);
+	buffer_chain &operator = (const buffer_chain &);
+};
+
+struct buffer_chain::region
+{
+	region(const uint8_t *d, size_t s, bool w) : data(d), size(s), writable(w) {}
+	const uint8_t *data;
+	size_t size;
+	bool writable;
+};
+
+// Read a buffer_chain (or any list of slices) with the usual e::unpacker
+// operators.  A value that straddles a segment boundary is decoded from a
+// copy of the bytes it spans; slices decoded from such a copy remain valid
+// for the life of the chain_unpacker.  Integers, slices, vectors and lists
+// are sized from their type or length prefix before anything is copied, so
+// a prefix that overruns the chain fails without copying.  Other values are
+// retried on a window that doubles each time, and a malformed one is only
+// reported once the window reaches the end of the chain.
+class chain_unpacker
+{
+public:
+	chain_unpacker(const buffer_chain &chain);
+	chain_unpacker(const std::vector<e::slice> &segments);
+	~chain_unpacker() throw ();
+
+public:
+	bool error() const { return m_error; }
+	size_t remain() const { return m_remain; }
+
+public:
+	template <typename T> chain_unpacker &operator >> (T &t) { return unpack(t); }
+	template <typename T> chain_unpacker &operator >> (const T &t) { return unpack(t); }
+
+private:
+	template <typename T> chain_unpacker &unpack(T &t);
+	e::slice window() const;
+	void widen(size_t sz);
+	void consume(size_t sz);
+	size_t copy(uint8_t *dst, size_t sz) const;
+
+private:
+	// Bytes the next value is known to need, or 0 when that is unknown.
+	// size_t(-1) when its prefix is malformed or overruns the chain.
+	template <typename T> size_t need(const T *t) const { return fixed_size(t); }
+	template <typename T> size_t need(const std::vector<T> *) const
+	{ return prefixed(min_size(static_cast<const T *>(NULL))); }
+	template <typename T> size_t need(const std::list<T> *) const
+	{ return prefixed(min_size(static_cast<const T *>(NULL))); }
+	size_t need(const e::slice *) const { return prefixed(1); }
+	size_t prefixed(size_t elem) const;
+
+	template <typename T> static size_t fixed_size(const T *) { return 0; }
+	static size_t fixed_size(const int8_t *) { return sizeof(int8_t); }
+	static size_t fixed_size(const int16_t *) { return sizeof(int16_t); }
+	static size_t fixed_size(const int32_t *) { return sizeof(int32_t); }
+	static size_t fixed_size(const int64_t *) { return sizeof(int64_t); }
+	static size_t fixed_size(const uint8_t *) { return sizeof(uint8_t); }
+	static size_t fixed_size(const uint16_t *) { return sizeof(uint16_t); }
+	static size_t fixed_size(const uint32_t *) { return sizeof(uint32_t); }
+	static size_t fixed_size(const uint64_t *) { return sizeof(uint64_t); }
+	static size_t fixed_size(const double *) { return sizeof(double); }
+	template <typename T> static size_t min_size(const T *t)
+	{ return std::max(fixed_size(t), size_t(1)); }
+
+private:
+	std::vector<e::slice> m_segments;
+	size_t m_seg;
+	size_t m_off;
+	size_t m_remain;
+	e::buffer *m_window;
+	std::vector<e::buffer *> m_scratch;
+	bool m_error;
+
+private:
+	chain_unpacker(const chain_unpacker &);
+	chain_unpacker &operator = (const chain_unpacker &);
+};
+
+template <typename T>
+chain_unpacker &
+chain_unpacker :: unpack(T &t)
+{
+	size_t sz = need(&t);
+
+	while (!m_error)
+	{
+		if (sz > m_remain)
+		{
+			m_error = true;
+			break;
+		}
+
+		if (sz > window().size())
+		{
+			widen(sz);
+		}
+
+		const e::slice w = window();
+		e::unpacker up = e::unpacker(w) >> t;
+
+		if (!up.error())
+		{
+			consume(up.start() - w.data());
+			break;
+		}
+
+		if (w.size() >= m_remain)
+		{
+			m_error = true;
+			break;
+		}
+
+		// the value is longer than the window
+		sz = std::min(std::max(w.size() * 2, w.size() + 1), m_remain);
+	}
+
+	return *this;
+}
+
+} // namespace e
+
+#endif // e_buffer_chain_h_
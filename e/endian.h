@@ -29,36 +29,120 @@
 #define e_endian_h_
 
 // C
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 namespace e
 {
 
-uint8_t *pack8be(uint8_t number, uint8_t *buffer);
-uint8_t *pack8le(uint8_t number, uint8_t *buffer);
-uint8_t *pack16be(uint16_t number, uint8_t *buffer);
-uint8_t *pack16le(uint16_t number, uint8_t *buffer);
-uint8_t *pack32be(uint32_t number, uint8_t *buffer);
-uint8_t *pack32le(uint32_t number, uint8_t *buffer);
-uint8_t *pack64be(uint64_t number, uint8_t *buffer);
-uint8_t *pack64le(uint64_t number, uint8_t *buffer);
-uint8_t *packfloatbe(float number, uint8_t *buffer);
-uint8_t *packfloatle(float number, uint8_t *buffer);
-uint8_t *packdoublebe(double number, uint8_t *buffer);
-uint8_t *packdoublele(double number, uint8_t *buffer);
-
-const uint8_t *unpack8be(const uint8_t *buffer, uint8_t *number);
-const uint8_t *unpack8le(const uint8_t *buffer, uint8_t *number);
-const uint8_t *unpack16be(const uint8_t *buffer, uint16_t *number);
-const uint8_t *unpack16le(const uint8_t *buffer, uint16_t *number);
-const uint8_t *unpack32be(const uint8_t *buffer, uint32_t *number);
-const uint8_t *unpack32le(const uint8_t *buffer, uint32_t *number);
-const uint8_t *unpack64be(const uint8_t *buffer, uint64_t *number);
-const uint8_t *unpack64le(const uint8_t *buffer, uint64_t *number);
-const uint8_t *unpackfloatbe(const uint8_t *buffer, float *number);
-const uint8_t *unpackfloatle(const uint8_t *buffer, float *number);
-const uint8_t *unpackdoublebe(const uint8_t *buffer, double *number);
-const uint8_t *unpackdoublele(const uint8_t *buffer, double *number);
+// The single-number functions are inline so that loops over them (such as
+// those in e::packer and e::unpacker) compile down to a load or store plus
+// at most one byte swap.  endian.cc still exports each of them for code
+// built against earlier versions of this header.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define E_ENDIAN_be(SZ, X) __builtin_bswap ## SZ(X)
+#define E_ENDIAN_le(SZ, X) (X)
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define E_ENDIAN_be(SZ, X) (X)
+#define E_ENDIAN_le(SZ, X) __builtin_bswap ## SZ(X)
+#endif
+
+#ifdef E_ENDIAN_be
+#define INT_FUNCTIONS(SZ, END) \
+	inline uint8_t* \
+	pack ## SZ ## END(uint ## SZ ## _t number, uint8_t* buffer) \
+	{ \
+		number = E_ENDIAN_ ## END(SZ, number); \
+		memcpy(buffer, &number, sizeof(number)); \
+		return buffer + sizeof(number); \
+	} \
+	inline const uint8_t* \
+	unpack ## SZ ## END(const uint8_t* buffer, uint ## SZ ## _t* number) \
+	{ \
+		uint ## SZ ## _t tmp; \
+		memcpy(&tmp, buffer, sizeof(tmp)); \
+		*number = E_ENDIAN_ ## END(SZ, tmp); \
+		return buffer + sizeof(tmp); \
+	}
+#else
+// The host's byte order is unknown, so shift a byte at a time.
+#define E_ENDIAN_be(SZ, I) (SZ - 8 - 8 * (I))
+#define E_ENDIAN_le(SZ, I) (8 * (I))
+#define INT_FUNCTIONS(SZ, END) \
+	inline uint8_t* \
+	pack ## SZ ## END(uint ## SZ ## _t number, uint8_t* buffer) \
+	{ \
+		for (size_t i = 0; i < sizeof(number); ++i) \
+		{ \
+			buffer[i] = (number >> E_ENDIAN_ ## END(SZ, i)) & 0xff; \
+		} \
+		return buffer + sizeof(number); \
+	} \
+	inline const uint8_t* \
+	unpack ## SZ ## END(const uint8_t* buffer, uint ## SZ ## _t* number) \
+	{ \
+		uint ## SZ ## _t tmp = 0; \
+		for (size_t i = 0; i < sizeof(tmp); ++i) \
+		{ \
+			tmp |= static_cast<uint ## SZ ## _t>(buffer[i]) << E_ENDIAN_ ## END(SZ, i); \
+		} \
+		*number = tmp; \
+		return buffer + sizeof(tmp); \
+	}
+#endif
+
+inline uint8_t* pack8be(uint8_t number, uint8_t* buffer) { buffer[0] = number; return buffer + 1; }
+inline uint8_t* pack8le(uint8_t number, uint8_t* buffer) { buffer[0] = number; return buffer + 1; }
+inline const uint8_t* unpack8be(const uint8_t* buffer, uint8_t* number) { *number = buffer[0]; return buffer + 1; }
+inline const uint8_t* unpack8le(const uint8_t* buffer, uint8_t* number) { *number = buffer[0]; return buffer + 1; }
+INT_FUNCTIONS(16, be)
+INT_FUNCTIONS(16, le)
+INT_FUNCTIONS(32, be)
+INT_FUNCTIONS(32, le)
+INT_FUNCTIONS(64, be)
+INT_FUNCTIONS(64, le)
+
+#undef INT_FUNCTIONS
+#undef E_ENDIAN_le
+#undef E_ENDIAN_be
+
+#define FLOAT_FUNCTIONS(TYPE, SZ, END) \
+	inline uint8_t* \
+	pack ## TYPE ## END(TYPE number, uint8_t* buffer) \
+	{ \
+		uint ## SZ ## _t tmp; \
+		memcpy(&tmp, &number, sizeof(tmp)); \
+		return pack ## SZ ## END(tmp, buffer); \
+	} \
+	inline const uint8_t* \
+	unpack ## TYPE ## END(const uint8_t* buffer, TYPE* number) \
+	{ \
+		uint ## SZ ## _t tmp; \
+		const uint8_t* ret = unpack ## SZ ## END(buffer, &tmp); \
+		memcpy(number, &tmp, sizeof(tmp)); \
+		return ret; \
+	}
+
+FLOAT_FUNCTIONS(float, 32, be)
+FLOAT_FUNCTIONS(float, 32, le)
+FLOAT_FUNCTIONS(double, 64, be)
+FLOAT_FUNCTIONS(double, 64, le)
+
+#undef FLOAT_FUNCTIONS
+
+// Pack or unpack "n" numbers at once.  Each returns a pointer just past the
+// bytes written or read.  When the byte order matches the host's these are a
+// memcpy; otherwise they byte-swap with SSSE3 or AVX2 where available.
+uint8_t *pack32be_n(const uint32_t *numbers, size_t n, uint8_t *buffer);
+uint8_t *pack32le_n(const uint32_t *numbers, size_t n, uint8_t *buffer);
+uint8_t *pack64be_n(const uint64_t *numbers, size_t n, uint8_t *buffer);
+uint8_t *pack64le_n(const uint64_t *numbers, size_t n, uint8_t *buffer);
+
+const uint8_t *unpack32be_n(const uint8_t *buffer, size_t n, uint32_t *numbers);
+const uint8_t *unpack32le_n(const uint8_t *buffer, size_t n, uint32_t *numbers);
+const uint8_t *unpack64be_n(const uint8_t *buffer, size_t n, uint64_t *numbers);
+const uint8_t *unpack64le_n(const uint8_t *buffer, size_t n, uint64_t *numbers);
 
 #define SIGNED_WRAPPER(SZ, END) \
 	inline const uint8_t* \
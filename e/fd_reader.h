@@ -0,0 +1,148 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_fd_reader_h_
+#define e_fd_reader_h_
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// e
+#include <e/serialization.h>
+
+namespace e
+{
+
+// Decode a stream read incrementally from a file descriptor, using the
+// usual e::unpacker operators:
+//
+//     e::fd_reader r(fd);
+//     while (!r.done() && !r.error()) { r >> record; }
+//
+// Bytes are read into a window as decoding needs them.  A value that does
+// not fit in the window causes it to be refilled (and, if it is full, to
+// double up to max_window) before the value is decoded again, so processing
+// starts before the whole file is read.  Slices decoded from the stream
+// point into the window and are valid only until the next operator>>.
+class fd_reader
+{
+public:
+	static const size_t DEFAULT_WINDOW = 1048576;
+	static const size_t DEFAULT_MAX_WINDOW = 64 * 1048576;
+
+public:
+	fd_reader(int fd);
+	fd_reader(int fd, size_t window, size_t max_window);
+	~fd_reader() throw ();
+
+public:
+	// A value failed to decode (malformed, truncated or too large for the
+	// window) or reading failed; see io_error() for the latter.
+	bool error() const { return m_failed; }
+	int io_error() const { return m_error; }
+	// The fd is at end of file and every byte read has been consumed.
+	bool done();
+
+public:
+	template <typename T> fd_reader &operator >> (T &t) { return unpack(t); }
+	template <typename T> fd_reader &operator >> (const T &t) { return unpack(t); }
+
+private:
+	template <typename T> fd_reader &unpack(T &t);
+	bool refill();
+
+private:
+	const int m_fd;
+	const size_t m_max_window;
+	uint8_t *m_buf;
+	size_t m_cap;
+	size_t m_start;
+	size_t m_end;
+	bool m_eof;
+	bool m_failed;
+	int m_error;
+
+private:
+	fd_reader(const fd_reader &);
+	fd_reader &operator = (const fd_reader &);
+};
+
+template <typename T>
+fd_reader &
+fd_reader :: unpack(T &t)
+{
+	while (!m_failed)
+	{
+		e::unpacker up = e::unpacker(m_buf + m_start, m_end - m_start) >> t;
+
+		if (!up.error())
+		{
+			m_start = up.start() - m_buf;
+			break;
+		}
+
+		if (!refill())
+		{
+			m_failed = true;
+		}
+	}
+
+	return *this;
+}
+
+// Map a whole file read-only for decoding with an ordinary e::unpacker.
+// The mapping is advised MADV_SEQUENTIAL; calling consumed() as decoding
+// progresses drops the pages behind the unpacker so that files larger than
+// memory do not push everything else out of the page cache.
+class mapped_reader
+{
+public:
+	mapped_reader(int fd);
+	~mapped_reader() throw ();
+
+public:
+	int error() const { return m_error; }
+	size_t size() const { return m_size; }
+	e::unpacker unpack() const;
+	void consumed(const e::unpacker &up);
+
+private:
+	uint8_t *m_base;
+	size_t m_size;
+	size_t m_released;
+	int m_error;
+
+private:
+	mapped_reader(const mapped_reader &);
+	mapped_reader &operator = (const mapped_reader &);
+};
+
+} // namespace e
+
+#endif // e_fd_reader_h_
@@ -0,0 +1,111 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_fd_writer_h_
+#define e_fd_writer_h_
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+// e
+#include <e/serialization.h>
+
+namespace e
+{
+
+// Pack into a file descriptor through a fixed-size staging buffer, so that
+// output of any size is written in bounded memory.  Bytes are written
+// sequentially with write(2) as the staging buffer fills; a packer that
+// back-patches bytes already written out uses pwrite(2), which requires a
+// seekable fd.
+//
+// Errors cannot be reported through e::packer, so the first one is kept:
+// once error() is nonzero (an errno value) further writes are dropped.
+// Call flush() or sync() at the end and check the result; the destructor
+// flushes but has no way to report failure.
+//
+// Options:
+//  - SYNC: fdatasync(2) after every staging buffer is written, so the page
+//    cache never holds more than one buffer of unsynced output.
+//  - DIRECT: set O_DIRECT on the fd and write whole, block-aligned staging
+//    buffers with it.  flush() writes any unaligned tail with O_DIRECT
+//    cleared and leaves it cleared, so it belongs at the end of the stream.
+//    If the fd does not support O_DIRECT, or the current offset is not
+//    block aligned, writes proceed through the page cache.
+//
+// This is also a Sink for e::static_packer.
+class fd_writer
+{
+public:
+	static const size_t DEFAULT_STAGING = 1048576;
+	static const unsigned SYNC = 1;
+	static const unsigned DIRECT = 2;
+
+public:
+	fd_writer(int fd);
+	fd_writer(int fd, size_t staging, unsigned options);
+	~fd_writer() throw ();
+
+public:
+	int error() const { return m_error; }
+	// Bytes packed so far, written out or staged.
+	uint64_t size() const { return m_base + m_used; }
+	e::packer pack();
+	void write(size_t off, const uint8_t *ptr, size_t ptr_sz);
+	bool flush();
+	bool sync();
+
+private:
+	class bytes_manager;
+	void append(const uint8_t *ptr, size_t sz);
+	void patch(uint64_t off, const uint8_t *ptr, size_t sz);
+	void write_out(const uint8_t *ptr, size_t sz);
+	void flush_staging();
+	void set_direct(bool on);
+
+private:
+	const int m_fd;
+	const unsigned m_options;
+	const size_t m_cap;
+	uint8_t *m_staging;
+	size_t m_used;
+	uint64_t m_base;
+	off_t m_origin;
+	bool m_direct;
+	int m_error;
+
+private:
+	fd_writer(const fd_writer &);
+	fd_writer &operator = (const fd_writer &);
+};
+
+} // namespace e
+
+#endif // e_fd_writer_h_
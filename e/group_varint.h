@@ -0,0 +1,159 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_group_varint_h_
+#define e_group_varint_h_
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <vector>
+
+// e
+#include <e/serialization.h>
+
+namespace e
+{
+
+// Two byte-aligned codecs for arrays of uint32_t.  Each value is stored
+// little-endian in 1-4 bytes and its length is kept apart from its data as a
+// 2-bit code (length - 1), four codes to a control byte, so a decoder never
+// branches on the data bytes themselves:
+//
+//  - group varint: each control byte immediately precedes the data for its
+//    four values.
+//  - stream vbyte: all control bytes come first, followed by all data.
+//
+// A final group of fewer than four values has zero for its unused codes and
+// no data for them.  Decoding dispatches at load time to an SSSE3 shuffle
+// where available; both formats take the same space.
+size_t group_varint_length(const uint32_t *v, size_t n);
+inline size_t stream_vbyte_length(const uint32_t *v, size_t n) { return group_varint_length(v, n); }
+
+// Encode v[0..n) at dst and return a pointer just past the last byte written.
+// REQUIRES: dst has room for *_length(v, n) bytes
+uint8_t *group_varint_encode(uint8_t *dst, const uint32_t *v, size_t n);
+uint8_t *stream_vbyte_encode(uint8_t *dst, const uint32_t *v, size_t n);
+
+// Decode n values into out[0..n), returning a pointer just past the encoded
+// data, or NULL if it extends beyond "limit".
+const uint8_t *group_varint_decode(const uint8_t *p, const uint8_t *limit, uint32_t *out, size_t n);
+const uint8_t *stream_vbyte_decode(const uint8_t *p, const uint8_t *limit, uint32_t *out, size_t n);
+
+// Pack a std::vector<uint32_t> as a varint count followed by the encoded
+// values, and unpack it again with the matching wrapper:
+//
+//     pa = pa << e::pack_group_varints(postings);
+//     up = up >> e::unpack_group_varints(postings);
+enum vbyte_format
+{
+	GROUP_VARINT,
+	STREAM_VBYTE
+};
+
+// Pack the count and the encoding of v[0..n), encoding a bounded chunk at a
+// time on the stack and appending it to the packer.
+e::packer pack_vbytes(e::packer pa, const uint32_t *v, size_t n, vbyte_format fmt);
+
+template <int FMT>
+class vbyte_pack
+{
+public:
+	vbyte_pack(const std::vector<uint32_t> &_c) : c(_c) {}
+	~vbyte_pack() throw () {}
+
+public:
+	const std::vector<uint32_t> &c;
+};
+
+template <int FMT>
+class vbyte_unpack
+{
+public:
+	vbyte_unpack(std::vector<uint32_t> &_c) : c(_c) {}
+	~vbyte_unpack() throw () {}
+
+public:
+	std::vector<uint32_t> &c;
+};
+
+inline vbyte_pack<GROUP_VARINT> pack_group_varints(const std::vector<uint32_t> &c) { return vbyte_pack<GROUP_VARINT>(c); }
+inline vbyte_pack<STREAM_VBYTE> pack_stream_vbytes(const std::vector<uint32_t> &c) { return vbyte_pack<STREAM_VBYTE>(c); }
+inline vbyte_unpack<GROUP_VARINT> unpack_group_varints(std::vector<uint32_t> &c) { return vbyte_unpack<GROUP_VARINT>(c); }
+inline vbyte_unpack<STREAM_VBYTE> unpack_stream_vbytes(std::vector<uint32_t> &c) { return vbyte_unpack<STREAM_VBYTE>(c); }
+
+template <int FMT>
+size_t
+pack_size(const vbyte_pack<FMT> &x)
+{
+	const uint32_t *v = x.c.empty() ? NULL : &x.c[0];
+	return varint_length(x.c.size()) + group_varint_length(v, x.c.size());
+}
+
+template <int FMT>
+e::packer
+operator << (e::packer pa, const vbyte_pack<FMT> &x)
+{
+	const uint32_t *v = x.c.empty() ? NULL : &x.c[0];
+	return pack_vbytes(pa, v, x.c.size(), vbyte_format(FMT));
+}
+
+template <int FMT>
+e::unpacker
+operator >> (e::unpacker up, const vbyte_unpack<FMT> &x)
+{
+	uint64_t count = 0;
+	up = up >> unpack_varint(count);
+	x.c.clear();
+
+	// every value takes at least one byte
+	if (up.error() || count > up.remain())
+	{
+		return unpacker::error_out();
+	}
+
+	x.c.resize(count);
+	uint32_t *out = x.c.empty() ? NULL : &x.c[0];
+	const uint8_t *ptr = FMT == STREAM_VBYTE
+	                   ? stream_vbyte_decode(up.start(), up.limit(), out, count)
+	                   : group_varint_decode(up.start(), up.limit(), out, count);
+
+	if (!ptr)
+	{
+		x.c.clear();
+		return unpacker::error_out();
+	}
+
+	return unpacker(ptr, up.limit() - ptr);
+}
+
+} // namespace e
+
+#endif // e_group_varint_h_
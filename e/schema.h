@@ -0,0 +1,219 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_schema_h_
+#define e_schema_h_
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// STL
+#include <list>
+#include <utility>
+#include <vector>
+
+// e
+#include <e/serialization.h>
+#include <e/varint.h>
+
+// Declare a struct's fields once and generate pack_size, operator<< and
+// operator>> from the same list, so that the three cannot drift apart:
+//
+//     #define MESSAGE_FIELDS(F) F(uint64_t, id) F(uint32_t, version) F(e::slice, payload)
+//
+//     struct message
+//     {
+//         E_SCHEMA(message, MESSAGE_FIELDS)
+//     };
+//
+//     E_SCHEMA_SERIALIZATION(message, MESSAGE_FIELDS)
+//
+// Fields are packed in the order listed and may be std::vector, std::list or
+// std::pair of any packable type, schema structs included.  E_SCHEMA
+// declares the members and a default constructor that value-initializes
+// each of them; E_SCHEMA_SERIALIZATION must appear in the struct's namespace
+// so that the generated operators are found by argument-dependent lookup.
+// Field types must not contain a top-level comma; use a typedef for those.
+// A schema needs at least one field.
+//
+// When every field has a constant size (the integer types, double, and
+// other schema structs built only from those), the struct's encoded size is
+// the compile-time constant e::fixed_schema_size<T>::value, so buffers for it
+// can live on the stack.  Naming it for a variable-size struct does not
+// compile.
+
+#define E_SCHEMA_MEMBER(T, N) T N;
+#define E_SCHEMA_FIXED(T, N) && ::e::schema_traits< T >::fixed
+#define E_SCHEMA_SIZE(T, N) + ::e::schema_traits< T >::size
+#define E_SCHEMA_PACK_SIZE(T, N) + ::e::schema_pack_size(x.N)
+#define E_SCHEMA_PACK(T, N) << x.N
+#define E_SCHEMA_UNPACK(T, N) >> x.N
+
+// The constructor's initializer list is built without a trailing comma by
+// turning the fields into a sequence "(a)(b)(c)" that E_SCHEMA_INIT_0,
+// _1 and _2 walk in turn.  The walk ends on a bare E_SCHEMA_INIT_1 or _2,
+// which pasting "_END" removes.  Commas are deferred as E_SCHEMA_COMMA ()
+// so that they do not split the arguments of E_SCHEMA_CAT_I.
+#define E_SCHEMA_INIT_SEQ(T, N) (N)
+#define E_SCHEMA_INIT_0(N) N() E_SCHEMA_INIT_1
+#define E_SCHEMA_INIT_1(N) E_SCHEMA_COMMA E_SCHEMA_PARENS N() E_SCHEMA_INIT_2
+#define E_SCHEMA_INIT_2(N) E_SCHEMA_COMMA E_SCHEMA_PARENS N() E_SCHEMA_INIT_1
+#define E_SCHEMA_INIT_1_END
+#define E_SCHEMA_INIT_2_END
+#define E_SCHEMA_COMMA() ,
+#define E_SCHEMA_PARENS ()
+#define E_SCHEMA_CAT(A, B) E_SCHEMA_CAT_X(A, B)
+#define E_SCHEMA_CAT_X(A, B) E_SCHEMA_CAT_I(A, B)
+#define E_SCHEMA_CAT_I(A, B) A ## B
+#define E_SCHEMA_INIT(FIELDS) \
+	E_SCHEMA_CAT(E_SCHEMA_INIT_0 FIELDS(E_SCHEMA_INIT_SEQ), _END)
+
+#define E_SCHEMA(TYPE, FIELDS) \
+	FIELDS(E_SCHEMA_MEMBER) \
+	TYPE() : E_SCHEMA_INIT(FIELDS) {} \
+	typedef void e_schema_tag; \
+	enum { e_schema_fixed = true FIELDS(E_SCHEMA_FIXED) }; \
+	enum { e_schema_size = 0 FIELDS(E_SCHEMA_SIZE) };
+
+#define E_SCHEMA_SERIALIZATION(TYPE, FIELDS) \
+	inline size_t pack_size(const TYPE &x) \
+	{ return TYPE::e_schema_fixed ? size_t(TYPE::e_schema_size) : size_t(0 FIELDS(E_SCHEMA_PACK_SIZE)); } \
+	inline e::packer operator << (e::packer pa, const TYPE &x) \
+	{ return pa FIELDS(E_SCHEMA_PACK); } \
+	inline e::unpacker operator >> (e::unpacker up, TYPE &x) \
+	{ return up FIELDS(E_SCHEMA_UNPACK); }
+
+namespace e
+{
+
+template <typename T>
+struct is_schema
+{
+	template <typename U> static char test(typename U::e_schema_tag *);
+	template <typename U> static long test(...);
+	static const bool value = sizeof(test<T>(0)) == sizeof(char);
+};
+
+// Whether T always packs to the same number of bytes, and how many.
+template <typename T, bool S = is_schema<T>::value>
+struct schema_traits
+{
+	static const bool fixed = false;
+	static const size_t size = 0;
+};
+
+template <typename T>
+struct schema_traits<T, true>
+{
+	static const bool fixed = T::e_schema_fixed;
+	static const size_t size = T::e_schema_fixed ? size_t(T::e_schema_size) : 0;
+};
+
+#define E_SCHEMA_FIXED_TYPE(T) \
+	template <> \
+	struct schema_traits<T, false> \
+	{ \
+		static const bool fixed = true; \
+		static const size_t size = fixed_pack_size<T>::value; \
+	}
+
+E_SCHEMA_FIXED_TYPE(int8_t);
+E_SCHEMA_FIXED_TYPE(int16_t);
+E_SCHEMA_FIXED_TYPE(int32_t);
+E_SCHEMA_FIXED_TYPE(int64_t);
+E_SCHEMA_FIXED_TYPE(uint8_t);
+E_SCHEMA_FIXED_TYPE(uint16_t);
+E_SCHEMA_FIXED_TYPE(uint32_t);
+E_SCHEMA_FIXED_TYPE(uint64_t);
+E_SCHEMA_FIXED_TYPE(double);
+
+#undef E_SCHEMA_FIXED_TYPE
+
+template <typename T, bool F = schema_traits<T>::fixed>
+struct fixed_schema_size
+{
+};
+
+template <typename T>
+struct fixed_schema_size<T, true>
+{
+	static const size_t value = schema_traits<T>::size;
+};
+
+// The container overloads recurse through schema_pack_size rather than the
+// global pack_size overloads, which cannot see schema structs' pack_size.
+template <typename T> size_t schema_pack_size(const std::vector<T> &v);
+template <typename T> size_t schema_pack_size(const std::list<T> &l);
+template <typename A, typename B> size_t schema_pack_size(const std::pair<A, B> &p);
+
+template <typename T>
+inline size_t
+schema_pack_size(const T &t)
+{
+	return pack_size(t);
+}
+
+template <typename T>
+inline size_t
+schema_pack_size(const std::vector<T> &v)
+{
+	size_t sz = varint_length(v.size());
+
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		sz += schema_pack_size(v[i]);
+	}
+
+	return sz;
+}
+
+template <typename T>
+inline size_t
+schema_pack_size(const std::list<T> &l)
+{
+	size_t sz = varint_length(l.size());
+
+	for (typename std::list<T>::const_iterator it = l.begin(); it != l.end(); ++it)
+	{
+		sz += schema_pack_size(*it);
+	}
+
+	return sz;
+}
+
+template <typename A, typename B>
+inline size_t
+schema_pack_size(const std::pair<A, B> &p)
+{
+	return schema_pack_size(p.first) + schema_pack_size(p.second);
+}
+
+} // namespace e
+
+#endif // e_schema_h_
@@ -42,6 +42,7 @@
 
 // e
 #include <e/compat.h>
+#include <e/endian.h>
 #include <e/slice.h>
 #include <e/varint.h>
 
@@ -52,6 +53,9 @@
 namespace e
 {
 class buffer;
+class buffer_chain;
+class fd_writer;
+template <typename Sink> class static_packer;
 
 inline uint64_t pack_size(int8_t) { return 1; }
 inline uint64_t pack_size(int16_t) { return 2; }
@@ -71,13 +75,23 @@ public:
 	packer(std::string *str);
 	packer(std::string *str, size_t off);
 	packer(e::buffer *buf, size_t off);
+	// Grow *buf (reallocating it and updating *buf) instead of aborting when
+	// a write does not fit.  *buf may be NULL and must not live in an arena.
+	packer(e::buffer **buf, size_t off);
 	packer(const packer &other);
 	~packer() throw ();
 
 public:
+	size_t offset() const { return m_off; }
 	void append(const uint8_t *ptr, size_t ptr_sz, packer *pa);
+	// Like append, but the bytes manager may keep a pointer to [ptr, ptr +
+	// ptr_sz) instead of copying it; only managers that say so do.
+	void reference(const uint8_t *ptr, size_t ptr_sz, packer *pa);
 
 public:
+	packer &operator = (const packer &rhs);
+	packer operator << (const std::vector<uint32_t> &rhs);
+	packer operator << (const std::vector<uint64_t> &rhs);
 	template <typename T> packer operator << (const std::vector<T> &rhs);
 	template <typename T> packer operator << (const std::list<T> &rhs);
 	template <typename A, typename B> packer operator << (const std::pair<A, B> &rhs);
@@ -87,6 +101,8 @@ public:
 		virtual ~bytes_manager() throw ();
 
 		virtual void write(size_t off, const uint8_t *ptr, size_t ptr_sz) = 0;
+		// defaults to write()
+		virtual void reference(size_t off, const uint8_t *ptr, size_t ptr_sz);
 
 	private:
 		bytes_manager(const bytes_manager &);
@@ -94,6 +110,11 @@ public:
 	};
 
 private:
+	// Only targets in this library may supply their own bytes_manager;
+	// each hands out packers through its own pack() or operator<<.
+	friend class buffer_chain;
+	friend class fd_writer;
+	template <typename Sink> friend class static_packer;
 	packer(e::compat::shared_ptr<bytes_manager> mgr, size_t off);
 
 private:
@@ -125,6 +146,8 @@ public:
 
 public:
 	unpacker &operator = (const unpacker &rhs);
+	unpacker operator >> (std::vector<uint32_t> &rhs);
+	unpacker operator >> (std::vector<uint64_t> &rhs);
 	template <typename T> unpacker operator >> (std::vector<T> &rhs);
 	template <typename T> unpacker operator >> (std::list<T> &rhs);
 	template <typename A, typename B> unpacker operator >> (std::pair<A, B> &rhs);
@@ -366,6 +389,409 @@ operator >> (e::unpacker up, const unpack_uint16<T> &x)
 	return up;
 }
 
+/////////////////////////////////////////////////////////
+
+// Records whose fields all have a fixed encoded size can be packed and
+// unpacked with a single bounds check:
+//
+//     up = up >> e::unpack_fixed(id, version, flags);
+//     pa = pa << e::pack_fixed(id, version, flags);
+//
+// Up to eight fields of the integer types and double are supported.
+struct fixed_none {};
+
+template <typename T> struct fixed_pack_size;
+template <> struct fixed_pack_size<fixed_none> { static const size_t value = 0; };
+template <> struct fixed_pack_size<int8_t> { static const size_t value = 1; };
+template <> struct fixed_pack_size<int16_t> { static const size_t value = 2; };
+template <> struct fixed_pack_size<int32_t> { static const size_t value = 4; };
+template <> struct fixed_pack_size<int64_t> { static const size_t value = 8; };
+template <> struct fixed_pack_size<uint8_t> { static const size_t value = 1; };
+template <> struct fixed_pack_size<uint16_t> { static const size_t value = 2; };
+template <> struct fixed_pack_size<uint32_t> { static const size_t value = 4; };
+template <> struct fixed_pack_size<uint64_t> { static const size_t value = 8; };
+template <> struct fixed_pack_size<double> { static const size_t value = 8; };
+
+inline uint8_t *pack_fixed_field(fixed_none, uint8_t *p) { return p; }
+inline uint8_t *pack_fixed_field(int8_t x, uint8_t *p) { return e::pack8be(x, p); }
+inline uint8_t *pack_fixed_field(int16_t x, uint8_t *p) { return e::pack16be(x, p); }
+inline uint8_t *pack_fixed_field(int32_t x, uint8_t *p) { return e::pack32be(x, p); }
+inline uint8_t *pack_fixed_field(int64_t x, uint8_t *p) { return e::pack64be(x, p); }
+inline uint8_t *pack_fixed_field(uint8_t x, uint8_t *p) { return e::pack8be(x, p); }
+inline uint8_t *pack_fixed_field(uint16_t x, uint8_t *p) { return e::pack16be(x, p); }
+inline uint8_t *pack_fixed_field(uint32_t x, uint8_t *p) { return e::pack32be(x, p); }
+inline uint8_t *pack_fixed_field(uint64_t x, uint8_t *p) { return e::pack64be(x, p); }
+inline uint8_t *pack_fixed_field(double x, uint8_t *p) { return e::packdoublebe(x, p); }
+
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, fixed_none *) { return p; }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, int8_t *x) { return e::unpack8be(p, x); }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, int16_t *x) { return e::unpack16be(p, x); }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, int32_t *x) { return e::unpack32be(p, x); }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, int64_t *x) { return e::unpack64be(p, x); }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, uint8_t *x) { return e::unpack8be(p, x); }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, uint16_t *x) { return e::unpack16be(p, x); }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, uint32_t *x) { return e::unpack32be(p, x); }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, uint64_t *x) { return e::unpack64be(p, x); }
+inline const uint8_t *unpack_fixed_field(const uint8_t *p, double *x) { return e::unpackdoublebe(p, x); }
+
+#define E_FIXED_TEMPLATE \
+	template <typename A, typename B, typename C, typename D, \
+	          typename E, typename F, typename G, typename H>
+#define E_FIXED_ARGS A, B, C, D, E, F, G, H
+
+template <typename A, typename B = fixed_none, typename C = fixed_none, typename D = fixed_none,
+          typename E = fixed_none, typename F = fixed_none, typename G = fixed_none, typename H = fixed_none>
+class fixed_pack
+{
+public:
+	static const size_t size = fixed_pack_size<A>::value + fixed_pack_size<B>::value
+	                         + fixed_pack_size<C>::value + fixed_pack_size<D>::value
+	                         + fixed_pack_size<E>::value + fixed_pack_size<F>::value
+	                         + fixed_pack_size<G>::value + fixed_pack_size<H>::value;
+
+public:
+	fixed_pack(const A &_a, const B &_b = B(), const C &_c = C(), const D &_d = D(),
+	           const E &_e = E(), const F &_f = F(), const G &_g = G(), const H &_h = H())
+		: a(_a), b(_b), c(_c), d(_d), e(_e), f(_f), g(_g), h(_h) {}
+	~fixed_pack() throw () {}
+
+public:
+	uint8_t *encode(uint8_t *p) const
+	{
+		p = pack_fixed_field(a, p);
+		p = pack_fixed_field(b, p);
+		p = pack_fixed_field(c, p);
+		p = pack_fixed_field(d, p);
+		p = pack_fixed_field(e, p);
+		p = pack_fixed_field(f, p);
+		p = pack_fixed_field(g, p);
+		p = pack_fixed_field(h, p);
+		return p;
+	}
+
+public:
+	A a; B b; C c; D d; E e; F f; G g; H h;
+};
+
+template <typename A, typename B = fixed_none, typename C = fixed_none, typename D = fixed_none,
+          typename E = fixed_none, typename F = fixed_none, typename G = fixed_none, typename H = fixed_none>
+class fixed_unpack
+{
+public:
+	static const size_t size = fixed_pack<E_FIXED_ARGS>::size;
+
+public:
+	fixed_unpack(A *_a, B *_b = NULL, C *_c = NULL, D *_d = NULL,
+	             E *_e = NULL, F *_f = NULL, G *_g = NULL, H *_h = NULL)
+		: a(_a), b(_b), c(_c), d(_d), e(_e), f(_f), g(_g), h(_h) {}
+	fixed_unpack(const fixed_unpack &o)
+		: a(o.a), b(o.b), c(o.c), d(o.d), e(o.e), f(o.f), g(o.g), h(o.h) {}
+	~fixed_unpack() throw () {}
+
+public:
+	fixed_unpack &operator = (const fixed_unpack &rhs)
+	{
+		a = rhs.a; b = rhs.b; c = rhs.c; d = rhs.d;
+		e = rhs.e; f = rhs.f; g = rhs.g; h = rhs.h;
+		return *this;
+	}
+
+public:
+	const uint8_t *decode(const uint8_t *p) const
+	{
+		p = unpack_fixed_field(p, a);
+		p = unpack_fixed_field(p, b);
+		p = unpack_fixed_field(p, c);
+		p = unpack_fixed_field(p, d);
+		p = unpack_fixed_field(p, e);
+		p = unpack_fixed_field(p, f);
+		p = unpack_fixed_field(p, g);
+		p = unpack_fixed_field(p, h);
+		return p;
+	}
+
+public:
+	A *a; B *b; C *c; D *d; E *e; F *f; G *g; H *h;
+};
+
+E_FIXED_TEMPLATE const size_t fixed_pack<E_FIXED_ARGS>::size;
+E_FIXED_TEMPLATE const size_t fixed_unpack<E_FIXED_ARGS>::size;
+
+E_FIXED_TEMPLATE
+e::packer
+operator << (e::packer pa, const fixed_pack<E_FIXED_ARGS> &x)
+{
+	uint8_t buf[fixed_pack<E_FIXED_ARGS>::size + 1];
+	pa.append(buf, x.encode(buf) - buf, &pa);
+	return pa;
+}
+
+E_FIXED_TEMPLATE
+e::unpacker
+operator >> (e::unpacker up, const fixed_unpack<E_FIXED_ARGS> &x)
+{
+	const size_t sz = fixed_unpack<E_FIXED_ARGS>::size;
+
+	if (up.error() || up.remain() < sz)
+	{
+		return unpacker::error_out();
+	}
+
+	x.decode(up.start());
+	return unpacker(up.start() + sz, up.remain() - sz);
+}
+
+template <typename A>
+fixed_pack<A>
+pack_fixed(const A &a)
+{ return fixed_pack<A>(a); }
+template <typename A, typename B>
+fixed_pack<A, B>
+pack_fixed(const A &a, const B &b)
+{ return fixed_pack<A, B>(a, b); }
+template <typename A, typename B, typename C>
+fixed_pack<A, B, C>
+pack_fixed(const A &a, const B &b, const C &c)
+{ return fixed_pack<A, B, C>(a, b, c); }
+template <typename A, typename B, typename C, typename D>
+fixed_pack<A, B, C, D>
+pack_fixed(const A &a, const B &b, const C &c, const D &d)
+{ return fixed_pack<A, B, C, D>(a, b, c, d); }
+template <typename A, typename B, typename C, typename D, typename E>
+fixed_pack<A, B, C, D, E>
+pack_fixed(const A &a, const B &b, const C &c, const D &d, const E &e)
+{ return fixed_pack<A, B, C, D, E>(a, b, c, d, e); }
+template <typename A, typename B, typename C, typename D, typename E, typename F>
+fixed_pack<A, B, C, D, E, F>
+pack_fixed(const A &a, const B &b, const C &c, const D &d, const E &e, const F &f)
+{ return fixed_pack<A, B, C, D, E, F>(a, b, c, d, e, f); }
+template <typename A, typename B, typename C, typename D, typename E, typename F, typename G>
+fixed_pack<A, B, C, D, E, F, G>
+pack_fixed(const A &a, const B &b, const C &c, const D &d, const E &e, const F &f, const G &g)
+{ return fixed_pack<A, B, C, D, E, F, G>(a, b, c, d, e, f, g); }
+E_FIXED_TEMPLATE
+fixed_pack<E_FIXED_ARGS>
+pack_fixed(const A &a, const B &b, const C &c, const D &d, const E &e, const F &f, const G &g, const H &h)
+{ return fixed_pack<E_FIXED_ARGS>(a, b, c, d, e, f, g, h); }
+
+template <typename A>
+fixed_unpack<A>
+unpack_fixed(A &a)
+{ return fixed_unpack<A>(&a); }
+template <typename A, typename B>
+fixed_unpack<A, B>
+unpack_fixed(A &a, B &b)
+{ return fixed_unpack<A, B>(&a, &b); }
+template <typename A, typename B, typename C>
+fixed_unpack<A, B, C>
+unpack_fixed(A &a, B &b, C &c)
+{ return fixed_unpack<A, B, C>(&a, &b, &c); }
+template <typename A, typename B, typename C, typename D>
+fixed_unpack<A, B, C, D>
+unpack_fixed(A &a, B &b, C &c, D &d)
+{ return fixed_unpack<A, B, C, D>(&a, &b, &c, &d); }
+template <typename A, typename B, typename C, typename D, typename E>
+fixed_unpack<A, B, C, D, E>
+unpack_fixed(A &a, B &b, C &c, D &d, E &e)
+{ return fixed_unpack<A, B, C, D, E>(&a, &b, &c, &d, &e); }
+template <typename A, typename B, typename C, typename D, typename E, typename F>
+fixed_unpack<A, B, C, D, E, F>
+unpack_fixed(A &a, B &b, C &c, D &d, E &e, F &f)
+{ return fixed_unpack<A, B, C, D, E, F>(&a, &b, &c, &d, &e, &f); }
+template <typename A, typename B, typename C, typename D, typename E, typename F, typename G>
+fixed_unpack<A, B, C, D, E, F, G>
+unpack_fixed(A &a, B &b, C &c, D &d, E &e, F &f, G &g)
+{ return fixed_unpack<A, B, C, D, E, F, G>(&a, &b, &c, &d, &e, &f, &g); }
+E_FIXED_TEMPLATE
+fixed_unpack<E_FIXED_ARGS>
+unpack_fixed(A &a, B &b, C &c, D &d, E &e, F &f, G &g, H &h)
+{ return fixed_unpack<E_FIXED_ARGS>(&a, &b, &c, &d, &e, &f, &g, &h); }
+
+/////////////////////////////////////////////////////////
+
+// Compact, opt-in encodings for containers of integers (std::vector,
+// std::list or anything with size(), const_iterator, clear() and
+// push_back()).  Each is a varint count followed by one varint per element:
+//
+//  - pack_varints: the value itself
+//  - pack_zigzags: the zigzag-encoded value, for signed data near zero
+//  - pack_delta_varints: the difference from the previous element, for
+//    sorted data.  Differences wrap around, so unsorted data still decodes
+//    correctly, it just does not shrink.
+//
+// They must be unpacked with the matching unpack_* wrapper.  Unpacking fails
+// if a decoded value does not fit the container's element type.
+enum varint_encoding
+{
+	VARINT_PLAIN,
+	VARINT_ZIGZAG,
+	VARINT_DELTA
+};
+
+template <int ENC, typename T>
+inline uint64_t
+varint_element_encode(T x, uint64_t *prev)
+{
+	if (ENC == VARINT_ZIGZAG)
+	{
+		return zigzag_encode(static_cast<int64_t>(x));
+	}
+
+	const uint64_t v = static_cast<uint64_t>(x);
+
+	if (ENC == VARINT_DELTA)
+	{
+		const uint64_t d = v - *prev;
+		*prev = v;
+		return d;
+	}
+
+	return v;
+}
+
+template <int ENC, typename T>
+inline bool
+varint_element_decode(uint64_t v, uint64_t *prev, T *x)
+{
+	if (ENC == VARINT_ZIGZAG)
+	{
+		const int64_t s = zigzag_decode(v);
+		*x = static_cast<T>(s);
+		return static_cast<int64_t>(*x) == s;
+	}
+
+	if (ENC == VARINT_DELTA)
+	{
+		v += *prev;
+		*prev = v;
+	}
+
+	*x = static_cast<T>(v);
+	return static_cast<uint64_t>(*x) == v;
+}
+
+template <typename C, int ENC>
+class varint_pack
+{
+public:
+	varint_pack(const C &_c) : c(_c) {}
+	~varint_pack() throw () {}
+
+public:
+	const C &c;
+};
+
+template <typename C, int ENC>
+class varint_unpack
+{
+public:
+	varint_unpack(C &_c) : c(_c) {}
+	~varint_unpack() throw () {}
+
+public:
+	C &c;
+};
+
+template <typename C> varint_pack<C, VARINT_PLAIN> pack_varints(const C &c) { return varint_pack<C, VARINT_PLAIN>(c); }
+template <typename C> varint_pack<C, VARINT_ZIGZAG> pack_zigzags(const C &c) { return varint_pack<C, VARINT_ZIGZAG>(c); }
+template <typename C> varint_pack<C, VARINT_DELTA> pack_delta_varints(const C &c) { return varint_pack<C, VARINT_DELTA>(c); }
+template <typename C> varint_unpack<C, VARINT_PLAIN> unpack_varints(C &c) { return varint_unpack<C, VARINT_PLAIN>(c); }
+template <typename C> varint_unpack<C, VARINT_ZIGZAG> unpack_zigzags(C &c) { return varint_unpack<C, VARINT_ZIGZAG>(c); }
+template <typename C> varint_unpack<C, VARINT_DELTA> unpack_delta_varints(C &c) { return varint_unpack<C, VARINT_DELTA>(c); }
+
+template <typename C, int ENC>
+size_t
+pack_size(const varint_pack<C, ENC> &x)
+{
+	size_t sz = varint_length(x.c.size());
+	uint64_t prev = 0;
+
+	for (typename C::const_iterator it = x.c.begin(); it != x.c.end(); ++it)
+	{
+		sz += varint_length(varint_element_encode<ENC>(*it, &prev));
+	}
+
+	return sz;
+}
+
+template <typename C, int ENC>
+e::packer
+operator << (e::packer pa, const varint_pack<C, ENC> &x)
+{
+	// encode runs of elements on the stack and append them together
+	uint64_t vs[64];
+	uint8_t buf[sizeof(vs) / sizeof(uint64_t) * 10];
+	size_t n = 0;
+	uint64_t prev = 0;
+	e::packer out = pa << pack_varint(x.c.size());
+
+	for (typename C::const_iterator it = x.c.begin(); it != x.c.end(); ++it)
+	{
+		vs[n++] = varint_element_encode<ENC>(*it, &prev);
+
+		if (n == sizeof(vs) / sizeof(uint64_t))
+		{
+			out.append(buf, varint64_encode_n(buf, vs, n) - buf, &out);
+			n = 0;
+		}
+	}
+
+	if (n > 0)
+	{
+		out.append(buf, varint64_encode_n(buf, vs, n) - buf, &out);
+	}
+
+	return out;
+}
+
+template <typename C, int ENC>
+e::unpacker
+operator >> (e::unpacker up, const varint_unpack<C, ENC> &x)
+{
+	uint64_t count = 0;
+	up = up >> unpack_varint(count);
+	x.c.clear();
+
+	// every element takes at least one byte
+	if (up.error() || count > up.remain())
+	{
+		return unpacker::error_out();
+	}
+
+	// decode runs of elements on the stack and convert them together
+	const uint8_t *ptr = up.start();
+	const uint8_t *const limit = up.limit();
+	uint64_t vs[128];
+	uint64_t prev = 0;
+
+	while (count > 0)
+	{
+		const size_t n = count < 128 ? count : 128;
+		ptr = varint64_decode_n(ptr, limit, vs, n);
+
+		if (!ptr)
+		{
+			return unpacker::error_out();
+		}
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			typename C::value_type t;
+
+			if (!varint_element_decode<ENC>(vs[i], &prev, &t))
+			{
+				return unpacker::error_out();
+			}
+
+			x.c.push_back(t);
+		}
+
+		count -= n;
+	}
+
+	return unpacker(ptr, limit - ptr);
+}
+
 } // namespace e
 
 // vector<T>
@@ -477,5 +903,7 @@ e :: unpacker :: operator >> (std::pair<A, B> &p)
 }
 
 #undef E_SERIALIZATION_TRIPLET
+#undef E_FIXED_TEMPLATE
+#undef E_FIXED_ARGS
 
 #endif // e_serialization_h_
@@ -0,0 +1,145 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_shared_buffer_h_
+#define e_shared_buffer_h_
+
+// C
+#include <stdlib.h>
+
+// e
+#include <e/buffer.h>
+#include <e/intrusive_ptr.h>
+#include <e/serialization.h>
+#include <e/slice.h>
+
+namespace e
+{
+class shared_slice;
+
+// An immutable, reference-counted byte buffer.  Hold it through
+// e::intrusive_ptr (shared_buffer::ref); the bytes are freed when the last
+// reference, including those held by shared_slices, goes away.
+class shared_buffer
+{
+public:
+	typedef e::intrusive_ptr<shared_buffer> ref;
+	static ref create(const char *buf, size_t sz);
+	// Take ownership of "buf" without copying it.  "buf" must have come from
+	// the heap (not an arena) and must not be used or deleted afterwards.
+	static ref adopt(e::buffer *buf);
+
+public:
+	size_t size() const { return m_buf->size(); }
+	const uint8_t *data() const { return m_buf->data(); }
+	const char *cdata() const { return m_buf->cdata(); }
+	e::slice as_slice() const { return m_buf->as_slice(); }
+	std::string hex() const { return m_buf->hex(); }
+	e::unpacker unpack() const { return e::unpacker(as_slice()); }
+	// Refer to [off, off + sz) of this buffer, clamped to its size, keeping
+	// the buffer alive for as long as the slice exists.
+	shared_slice slice(size_t off, size_t sz) const;
+
+private:
+	friend class e::intrusive_ptr<shared_buffer>;
+	shared_buffer(e::buffer *buf);
+	~shared_buffer() throw ();
+	void inc() { __sync_add_and_fetch(&m_ref, 1); }
+	void dec() { if (__sync_sub_and_fetch(&m_ref, 1) == 0) delete this; }
+
+private:
+	size_t m_ref;
+	e::buffer *m_buf;
+
+private:
+	shared_buffer(const shared_buffer &);
+	shared_buffer &operator = (const shared_buffer &);
+};
+
+// A range of a shared_buffer that shares its storage.  Copying a
+// shared_slice copies a reference, never the bytes.
+class shared_slice
+{
+public:
+	shared_slice();
+	shared_slice(const shared_buffer::ref &buf);
+	shared_slice(const shared_buffer::ref &buf, size_t off, size_t sz);
+	// "s" must lie within "buf".
+	shared_slice(const shared_buffer::ref &buf, const e::slice &s);
+	shared_slice(const shared_slice &other);
+	~shared_slice() throw ();
+
+public:
+	const uint8_t *data() const { return m_data; }
+	const char *cdata() const { return reinterpret_cast<const char *>(m_data); }
+	bool empty() const { return m_sz == 0; }
+	size_t size() const { return m_sz; }
+	e::slice as_slice() const { return e::slice(m_data, m_sz); }
+	e::unpacker unpack() const { return e::unpacker(as_slice()); }
+	const shared_buffer::ref &owner() const { return m_buf; }
+	// A sub-range of this slice, clamped to its size.
+	shared_slice sub(size_t off, size_t sz) const;
+
+public:
+	shared_slice &operator = (const shared_slice &rhs);
+
+private:
+	shared_buffer::ref m_buf;
+	const uint8_t *m_data;
+	size_t m_sz;
+};
+
+size_t pack_size(const shared_slice &s);
+e::packer operator << (e::packer pa, const shared_slice &x);
+
+// Unpack an e::slice that refers into "buf" and bind it to "buf", so that it
+// stays valid after the unpacker and every other reference are gone:
+//
+//     e::shared_slice payload;
+//     up = up >> e::unpack_shared(buf, payload);
+//
+// The unpacker must be reading from "buf" (for instance buf->unpack(), or
+// the unpack() of a shared_slice owned by it); if the decoded bytes lie
+// outside "buf", unpacking fails.
+class unpack_shared
+{
+public:
+	unpack_shared(const shared_buffer::ref &_buf, shared_slice &_s) : buf(_buf), s(_s) {}
+	~unpack_shared() throw () {}
+
+public:
+	const shared_buffer::ref &buf;
+	shared_slice &s;
+};
+
+e::unpacker
+operator >> (e::unpacker up, const unpack_shared &x);
+
+} // namespace e
+
+#endif // e_shared_buffer_h_
@@ -44,6 +44,9 @@ namespace e
 // somewhere else, and must outlive the use of all slices using it.
 //
 // Comparisons are NOT lexicographic, just guaranteed to follow be consistent.
+// Use lexicographic_compare (or slice_lexicographic_less as a comparator) for
+// orders that must agree with a byte-by-byte sort, such as sorted indexes,
+// range scans and prefix searches.
 class slice
 {
 public:
@@ -58,6 +61,9 @@ public:
 
 public:
 	int compare(const slice &rhs) const;
+	int lexicographic_compare(const slice &rhs) const;
+	size_t common_prefix_length(const slice &rhs) const;
+	bool equals(const slice &rhs) const;
 	const uint8_t *data() const { return m_data; }
 	const char *cdata() const { return reinterpret_cast<const char *>(m_data); }
 	bool empty() const { return m_sz == 0; }
@@ -85,6 +91,14 @@ private:
 	size_t m_sz;
 };
 
+// Orders slices byte by byte, shorter slices first when one is a prefix of
+// the other, as memcmp-ordered stores and std::string do.
+struct slice_lexicographic_less
+{
+	bool operator () (const slice &lhs, const slice &rhs) const
+	{ return lhs.lexicographic_compare(rhs) < 0; }
+};
+
 } // namespace e
 
 #endif // e_slice_h_
@@ -0,0 +1,282 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef e_static_packer_h_
+#define e_static_packer_h_
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// STL
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// e
+#include <e/buffer.h>
+#include <e/compat.h>
+#include <e/endian.h>
+#include <e/serialization.h>
+#include <e/slice.h>
+#include <e/varint.h>
+
+namespace e
+{
+
+// Adapts a Sink to e::packer for types that only know how to pack into one.
+template <typename Sink>
+class sink_bytes_manager : public e::packer::bytes_manager
+{
+public:
+	sink_bytes_manager(Sink *sink) : m_sink(sink) {}
+	virtual ~sink_bytes_manager() throw () {}
+
+public:
+	virtual void write(size_t off, const uint8_t *ptr, size_t ptr_sz)
+	{ m_sink->write(off, ptr, ptr_sz); }
+
+private:
+	Sink *m_sink;
+
+private:
+	sink_bytes_manager(const sink_bytes_manager &);
+	sink_bytes_manager &operator = (const sink_bytes_manager &);
+};
+
+// A base for sinks that builds their sink_bytes_manager once.  The derived
+// sink calls adapt(this) from its constructor.
+class static_sink
+{
+protected:
+	static_sink() : m_mgr() {}
+	~static_sink() throw () {}
+	template <typename Sink> void adapt(Sink *sink)
+	{ m_mgr.reset(new sink_bytes_manager<Sink>(sink)); }
+
+private:
+	template <typename Sink> friend class static_packer;
+	e::compat::shared_ptr<e::packer::bytes_manager> m_mgr;
+
+private:
+	static_sink(const static_sink &);
+	static_sink &operator = (const static_sink &);
+};
+
+// A packer that calls its sink directly instead of going through a
+// reference-counted, virtual bytes_manager.  Copies are a pointer and an
+// offset, so "pa = pa << x" and back-patching through an earlier copy work
+// as they do with e::packer.  Integers, doubles, slices, pack_varint,
+// pack_memmove, pack_fixed and vectors of those are encoded inline; any
+// other type is packed with its existing e::packer operator<<.
+//
+// A Sink provides "void write(size_t off, const uint8_t *ptr, size_t sz)"
+// and must outlive every static_packer that refers to it.  Sinks derived from
+// e::static_sink (as buffer_sink and string_sink are) keep the adapter that
+// lets e::packer write to them; other sinks get a new one for every value
+// that goes through e::packer.
+template <typename Sink>
+class static_packer
+{
+public:
+	static_packer(Sink *sink) : m_sink(sink), m_off(0) {}
+	static_packer(Sink *sink, size_t off) : m_sink(sink), m_off(off) {}
+	static_packer(const static_packer &other) : m_sink(other.m_sink), m_off(other.m_off) {}
+	~static_packer() throw () {}
+
+public:
+	size_t offset() const { return m_off; }
+	static_packer append(const uint8_t *ptr, size_t ptr_sz) const;
+
+public:
+	static_packer &operator = (const static_packer &rhs)
+	{ m_sink = rhs.m_sink; m_off = rhs.m_off; return *this; }
+	static_packer operator << (int8_t x) const { uint8_t b[1]; return append(b, e::pack8be(x, b) - b); }
+	static_packer operator << (int16_t x) const { uint8_t b[2]; return append(b, e::pack16be(x, b) - b); }
+	static_packer operator << (int32_t x) const { uint8_t b[4]; return append(b, e::pack32be(x, b) - b); }
+	static_packer operator << (int64_t x) const { uint8_t b[8]; return append(b, e::pack64be(x, b) - b); }
+	static_packer operator << (uint8_t x) const { uint8_t b[1]; return append(b, e::pack8be(x, b) - b); }
+	static_packer operator << (uint16_t x) const { uint8_t b[2]; return append(b, e::pack16be(x, b) - b); }
+	static_packer operator << (uint32_t x) const { uint8_t b[4]; return append(b, e::pack32be(x, b) - b); }
+	static_packer operator << (uint64_t x) const { uint8_t b[8]; return append(b, e::pack64be(x, b) - b); }
+	static_packer operator << (double x) const { uint8_t b[8]; return append(b, e::packdoublebe(x, b) - b); }
+	static_packer operator << (const pack_varint &x) const { uint8_t b[10]; return append(b, e::packvarint64(x.x, b) - b); }
+	static_packer operator << (const pack_memmove &x) const { return append(x.data(), x.size()); }
+	static_packer operator << (const e::slice &x) const
+	{ return (*this << pack_varint(x.size())).append(x.data(), x.size()); }
+	template <typename A, typename B, typename C, typename D,
+	          typename E, typename F, typename G, typename H>
+	static_packer operator << (const fixed_pack<A, B, C, D, E, F, G, H> &x) const
+	{ uint8_t b[fixed_pack<A, B, C, D, E, F, G, H>::size + 1]; return append(b, x.encode(b) - b); }
+	static_packer operator << (const std::vector<uint32_t> &x) const { return pack_bulk(x, e::pack32be_n); }
+	static_packer operator << (const std::vector<uint64_t> &x) const { return pack_bulk(x, e::pack64be_n); }
+	template <typename T> static_packer operator << (const std::vector<T> &x) const;
+	template <typename T> static_packer operator << (const T &x) const;
+
+private:
+	typedef e::compat::shared_ptr<e::packer::bytes_manager> manager_ptr;
+	static manager_ptr manager(static_sink *s, Sink *) { return s->m_mgr; }
+	static manager_ptr manager(void *, Sink *sink);
+	template <typename T> static_packer pack_bulk(const std::vector<T> &x,
+	                                              uint8_t *(*pack)(const T *, size_t, uint8_t *)) const;
+
+private:
+	Sink *m_sink;
+	size_t m_off;
+};
+
+template <typename Sink>
+typename static_packer<Sink>::manager_ptr
+static_packer<Sink> :: manager(void *, Sink *sink)
+{
+	return manager_ptr(new sink_bytes_manager<Sink>(sink));
+}
+
+template <typename Sink>
+inline static_packer<Sink>
+static_packer<Sink> :: append(const uint8_t *ptr, size_t ptr_sz) const
+{
+	if (static_cast<size_t>(-1) - m_off < ptr_sz)
+	{
+		abort();
+	}
+
+	m_sink->write(m_off, ptr, ptr_sz);
+	return static_packer(m_sink, m_off + ptr_sz);
+}
+
+template <typename Sink>
+template <typename T>
+static_packer<Sink>
+static_packer<Sink> :: operator << (const std::vector<T> &x) const
+{
+	static_packer pa = *this << pack_varint(x.size());
+
+	for (size_t i = 0; i < x.size(); ++i)
+	{
+		pa = pa << x[i];
+	}
+
+	return pa;
+}
+
+template <typename Sink>
+template <typename T>
+static_packer<Sink>
+static_packer<Sink> :: pack_bulk(const std::vector<T> &x,
+                                 uint8_t *(*pack)(const T *, size_t, uint8_t *)) const
+{
+	// byte-swap through the stack in runs, as e::packer does
+	uint8_t buf[4096];
+	const size_t step = sizeof(buf) / sizeof(T);
+	static_packer pa = *this << pack_varint(x.size());
+
+	for (size_t i = 0; i < x.size(); i += step)
+	{
+		const size_t n = std::min(step, x.size() - i);
+		pa = pa.append(buf, pack(&x[i], n, buf) - buf);
+	}
+
+	return pa;
+}
+
+template <typename Sink>
+template <typename T>
+static_packer<Sink>
+static_packer<Sink> :: operator << (const T &x) const
+{
+	const e::packer pa = e::packer(manager(m_sink, m_sink), m_off) << x;
+	return static_packer(m_sink, pa.offset());
+}
+
+// Write into an e::buffer, aborting if it runs out of capacity (as packing
+// into an e::buffer does).
+class buffer_sink : public static_sink
+{
+public:
+	buffer_sink(e::buffer *buf) : m_buf(buf) { adapt(this); }
+	~buffer_sink() throw () {}
+
+public:
+	void write(size_t off, const uint8_t *ptr, size_t ptr_sz)
+	{
+		const size_t new_size = off + ptr_sz;
+
+		if (new_size > m_buf->capacity())
+		{
+			abort();
+		}
+
+		memmove(m_buf->data() + off, ptr, ptr_sz);
+
+		if (m_buf->size() < new_size)
+		{
+			m_buf->resize(new_size);
+		}
+	}
+
+private:
+	e::buffer *m_buf;
+
+private:
+	buffer_sink(const buffer_sink &);
+	buffer_sink &operator = (const buffer_sink &);
+};
+
+// Write into a std::string, growing it as needed.
+class string_sink : public static_sink
+{
+public:
+	string_sink(std::string *str) : m_str(str) { adapt(this); }
+	~string_sink() throw () {}
+
+public:
+	void write(size_t off, const uint8_t *ptr, size_t ptr_sz)
+	{
+		if (m_str->size() < off)
+		{
+			m_str->resize(off, '\0');
+		}
+
+		const size_t overlap = std::min(ptr_sz, m_str->size() - off);
+		memmove(&(*m_str)[0] + off, ptr, overlap);
+		m_str->append(reinterpret_cast<const char *>(ptr) + overlap, ptr_sz - overlap);
+	}
+
+private:
+	std::string *m_str;
+
+private:
+	string_sink(const string_sink &);
+	string_sink &operator = (const string_sink &);
+};
+
+} // namespace e
+
+#endif // e_static_packer_h_
@@ -14,6 +14,7 @@
 #ifndef e_varint_h_
 #define e_varint_h_
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace e
@@ -46,6 +47,22 @@ varint64_decode(const unsigned char *p, const unsigned char *limit, uint64_t *v)
 	        reinterpret_cast<const char *>(limit), v));
 }
 
+// Decode "n" consecutive varint64s into out[0..n), returning a pointer just
+// past the last one, or NULL if fewer than n complete values lie before
+// "limit".  Accepts exactly what varint64_decode accepts, but runs of
+// single-byte values and values of up to eight bytes are decoded without a
+// branch per byte.
+const char *
+varint64_decode_n(const char *p, const char *limit, uint64_t *out, size_t n);
+
+inline const unsigned char *
+varint64_decode_n(const unsigned char *p, const unsigned char *limit, uint64_t *out, size_t n)
+{
+	return reinterpret_cast<const unsigned char *>(varint64_decode_n(
+	        reinterpret_cast<const char *>(p),
+	        reinterpret_cast<const char *>(limit), out, n));
+}
+
 // Write directly into a character buffer and return a pointer just past the
 // last byte written.
 // REQUIRES: dst has enough space for the value being written
@@ -54,17 +71,46 @@ varint32_encode(char *dst, uint32_t value);
 char *
 varint64_encode(char *dst, uint64_t value);
 
+// Encode v[0..n) back to back.  Values that fit in eight bytes are written
+// with a single spread-and-mask step instead of a loop over 7-bit groups.
+// REQUIRES: dst has room for varint_length_n(v, n) bytes
+char *
+varint64_encode_n(char *dst, const uint64_t *v, size_t n);
+
+inline unsigned char *
+varint64_encode_n(unsigned char *dst, const uint64_t *v, size_t n)
+{
+	return reinterpret_cast<unsigned char *>(varint64_encode_n(
+	        reinterpret_cast<char *>(dst), v, n));
+}
+
 // Returns the length of the varint32 or varint64 encoding of "v"
 inline int
 varint_length(uint64_t v)
 {
-	int len = 1;
-	while (v >= 128)
-	{
-		v >>= 7;
-		len++;
-	}
-	return len;
+	// one byte per started group of 7 bits: ceil((floor(log2(v)) + 1) / 7),
+	// computed as a multiply and shift so it does not branch on v
+	const int bits = 63 - __builtin_clzll(v | 1);
+	return (bits * 9 + 73) >> 6;
+}
+
+// Returns the total length of the varint64 encodings of v[0..n), so that a
+// caller can size its output once before calling varint64_encode_n
+size_t
+varint_length_n(const uint64_t *v, size_t n);
+
+// Map signed integers onto unsigned ones so that values near zero, of
+// either sign, have short varint encodings: 0, -1, 1, -2, ... -> 0, 1, 2, 3
+inline uint64_t
+zigzag_encode(int64_t v)
+{
+	return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t
+zigzag_decode(uint64_t v)
+{
+	return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
 }
 
 // Helpful wrappers to match conventions from elsewhwere
@@ -27,230 +27,101 @@
 
 // C
 #include <stdint.h>
+#include <string.h>
 
 // e
 #include "e/endian.h"
-
-uint8_t *
-e :: pack8be(uint8_t number, uint8_t *buffer)
-{
-	buffer[0] = number;
-	return buffer + sizeof(uint8_t);
-}
-
-uint8_t *
-e :: pack8le(uint8_t number, uint8_t *buffer)
-{
-	buffer[0] = number;
-	return buffer + sizeof(uint8_t);
-}
-
-uint8_t *
-e :: pack16be(uint16_t number, uint8_t *buffer)
-{
-	buffer[0] = number >> 8;
-	buffer[1] = number & 0xff;
-	return buffer + sizeof(uint16_t);
-}
-
-uint8_t *
-e :: pack16le(uint16_t number, uint8_t *buffer)
-{
-	buffer[0] = number & 0xff;
-	buffer[1] = number >> 8;
-	return buffer + sizeof(uint16_t);
-}
-
-uint8_t *
-e :: pack32be(uint32_t number, uint8_t *buffer)
-{
-	buffer[0] = number >> 24;
-	buffer[1] = (number >> 16) & 0xff;
-	buffer[2] = (number >> 8) & 0xff;
-	buffer[3] = number & 0xff;
-	return buffer + sizeof(uint32_t);
-}
-
-uint8_t *
-e :: pack32le(uint32_t number, uint8_t *buffer)
-{
-	buffer[0] = number & 0xff;
-	buffer[1] = (number >> 8) & 0xff;
-	buffer[2] = (number >> 16) & 0xff;
-	buffer[3] = number >> 24;
-	return buffer + sizeof(uint32_t);
-}
-
-uint8_t *
-e :: pack64be(uint64_t number, uint8_t *buffer)
-{
-	buffer[0] = number >> 56;
-	buffer[1] = (number >> 48) & 0xff;
-	buffer[2] = (number >> 40) & 0xff;
-	buffer[3] = (number >> 32) & 0xff;
-	buffer[4] = (number >> 24) & 0xff;
-	buffer[5] = (number >> 16) & 0xff;
-	buffer[6] = (number >> 8) & 0xff;
-	buffer[7] = number & 0xff;
-	return buffer + sizeof(uint64_t);
-}
-
-uint8_t *
-e :: pack64le(uint64_t number, uint8_t *buffer)
-{
-	buffer[0] = number & 0xff;
-	buffer[1] = (number >> 8) & 0xff;
-	buffer[2] = (number >> 16) & 0xff;
-	buffer[3] = (number >> 24) & 0xff;
-	buffer[4] = (number >> 32) & 0xff;
-	buffer[5] = (number >> 40) & 0xff;
-	buffer[6] = (number >> 48) & 0xff;
-	buffer[7] = number >> 56;
-	return buffer + sizeof(uint64_t);
-}
-
-uint8_t *
-e :: packfloatbe(float number, uint8_t *buffer)
-{
-	union {float f; uint32_t i;};
-	f = number;
-	return pack32be(i, buffer);
-}
-
-uint8_t *
-e :: packfloatle(float number, uint8_t *buffer)
-{
-	union {float f; uint32_t i;};
-	f = number;
-	return pack32le(i, buffer);
-}
-
-uint8_t *
-e :: packdoublebe(double number, uint8_t *buffer)
-{
-	union {double d; uint64_t i;};
-	d = number;
-	return pack64be(i, buffer);
-}
-
-uint8_t *
-e :: packdoublele(double number, uint8_t *buffer)
-{
-	union {double d; uint64_t i;};
-	d = number;
-	return pack64le(i, buffer);
-}
-
-const uint8_t *
-e :: unpack8be(const uint8_t *buffer, uint8_t *number)
-{
-	*number = buffer[0];
-	return buffer + sizeof(uint8_t);
-}
-
-const uint8_t *
-e :: unpack8le(const uint8_t *buffer, uint8_t *number)
-{
-	*number = buffer[0];
-	return buffer + sizeof(uint8_t);
-}
-
-const uint8_t *
-e :: unpack16be(const uint8_t *buffer, uint16_t *number)
-{
-	*number = static_cast<uint16_t>(buffer[0]) << 8
-	          | static_cast<uint16_t>(buffer[1]);
-	return buffer + sizeof(uint16_t);
-}
-
-const uint8_t *
-e :: unpack16le(const uint8_t *buffer, uint16_t *number)
-{
-	*number = static_cast<uint16_t>(buffer[0])
-	          | static_cast<uint16_t>(buffer[1]) << 8;
-	return buffer + sizeof(uint16_t);
-}
-
-const uint8_t *
-e :: unpack32be(const uint8_t *buffer, uint32_t *number)
-{
-	*number = static_cast<uint32_t>(buffer[0]) << 24
-	          | static_cast<uint32_t>(buffer[1]) << 16
-	          | static_cast<uint32_t>(buffer[2]) << 8
-	          | static_cast<uint32_t>(buffer[3]);
-	return buffer + sizeof(uint32_t);
-}
-
-const uint8_t *
-e :: unpack32le(const uint8_t *buffer, uint32_t *number)
-{
-	*number = static_cast<uint32_t>(buffer[0])
-	          | static_cast<uint32_t>(buffer[1]) << 8
-	          | static_cast<uint32_t>(buffer[2]) << 16
-	          | static_cast<uint32_t>(buffer[3]) << 24;
-	return buffer + sizeof(uint32_t);
-}
-
-const uint8_t *
-e :: unpack64be(const uint8_t *buffer, uint64_t *number)
-{
-	*number = static_cast<uint64_t>(buffer[0]) << 56
-	          | static_cast<uint64_t>(buffer[1]) << 48
-	          | static_cast<uint64_t>(buffer[2]) << 40
-	          | static_cast<uint64_t>(buffer[3]) << 32
-	          | static_cast<uint64_t>(buffer[4]) << 24
-	          | static_cast<uint64_t>(buffer[5]) << 16
-	          | static_cast<uint64_t>(buffer[6]) << 8
-	          | static_cast<uint64_t>(buffer[7]);
-	return buffer + sizeof(uint64_t);
-}
-
-const uint8_t *
-e :: unpack64le(const uint8_t *buffer, uint64_t *number)
-{
-	*number = static_cast<uint64_t>(buffer[0])
-	          | static_cast<uint64_t>(buffer[1]) << 8
-	          | static_cast<uint64_t>(buffer[2]) << 16
-	          | static_cast<uint64_t>(buffer[3]) << 24
-	          | static_cast<uint64_t>(buffer[4]) << 32
-	          | static_cast<uint64_t>(buffer[5]) << 40
-	          | static_cast<uint64_t>(buffer[6]) << 48
-	          | static_cast<uint64_t>(buffer[7]) << 56;
-	return buffer + sizeof(uint64_t);
-}
-
-const uint8_t *
-e :: unpackfloatbe(const uint8_t *buffer, float *number)
-{
-	union {float f; uint32_t i;};
-	const uint8_t *ret = unpack32be(buffer, &i);
-	*number = f;
-	return ret;
-}
-
-const uint8_t *
-e :: unpackfloatle(const uint8_t *buffer, float *number)
-{
-	union {float f; uint32_t i;};
-	const uint8_t *ret = unpack32le(buffer, &i);
-	*number = f;
-	return ret;
-}
-
-const uint8_t *
-e :: unpackdoublebe(const uint8_t *buffer, double *number)
-{
-	union {double d; uint64_t i;};
-	const uint8_t *ret = unpack64be(buffer, &i);
-	*number = d;
-	return ret;
-}
-
-const uint8_t *
-e :: unpackdoublele(const uint8_t *buffer, double *number)
-{
-	union {double d; uint64_t i;};
-	const uint8_t *ret = unpack64le(buffer, &i);
-	*number = d;
-	return ret;
-}
+#include "bswap.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define E_BIG_ENDIAN_HOST 1
+#endif
+
+// The single-number functions are inline in e/endian.h.  Taking their
+// addresses here emits an out-of-line copy of each into the library, so
+// binaries linked against the old out-of-line versions keep working.
+namespace
+{
+
+typedef uint8_t *(*pack8_t)(uint8_t, uint8_t *);
+typedef uint8_t *(*pack16_t)(uint16_t, uint8_t *);
+typedef uint8_t *(*pack32_t)(uint32_t, uint8_t *);
+typedef uint8_t *(*pack64_t)(uint64_t, uint8_t *);
+typedef uint8_t *(*packfloat_t)(float, uint8_t *);
+typedef uint8_t *(*packdouble_t)(double, uint8_t *);
+typedef const uint8_t *(*unpack8_t)(const uint8_t *, uint8_t *);
+typedef const uint8_t *(*unpack16_t)(const uint8_t *, uint16_t *);
+typedef const uint8_t *(*unpack32_t)(const uint8_t *, uint32_t *);
+typedef const uint8_t *(*unpack64_t)(const uint8_t *, uint64_t *);
+typedef const uint8_t *(*unpackfloat_t)(const uint8_t *, float *);
+typedef const uint8_t *(*unpackdouble_t)(const uint8_t *, double *);
+
+__attribute__ ((used)) const pack8_t abi_pack8[] = {e::pack8be, e::pack8le};
+__attribute__ ((used)) const pack16_t abi_pack16[] = {e::pack16be, e::pack16le};
+__attribute__ ((used)) const pack32_t abi_pack32[] = {e::pack32be, e::pack32le};
+__attribute__ ((used)) const pack64_t abi_pack64[] = {e::pack64be, e::pack64le};
+__attribute__ ((used)) const packfloat_t abi_packfloat[] = {e::packfloatbe, e::packfloatle};
+__attribute__ ((used)) const packdouble_t abi_packdouble[] = {e::packdoublebe, e::packdoublele};
+__attribute__ ((used)) const unpack8_t abi_unpack8[] = {e::unpack8be, e::unpack8le};
+__attribute__ ((used)) const unpack16_t abi_unpack16[] = {e::unpack16be, e::unpack16le};
+__attribute__ ((used)) const unpack32_t abi_unpack32[] = {e::unpack32be, e::unpack32le};
+__attribute__ ((used)) const unpack64_t abi_unpack64[] = {e::unpack64be, e::unpack64le};
+__attribute__ ((used)) const unpackfloat_t abi_unpackfloat[] = {e::unpackfloatbe, e::unpackfloatle};
+__attribute__ ((used)) const unpackdouble_t abi_unpackdouble[] = {e::unpackdoublebe, e::unpackdoublele};
+
+} // namespace
+
+// The byte order that matches the host is a copy; the other is a swap.
+#if defined(E_BIG_ENDIAN_HOST)
+#define E_BULK_BE(W, SRC, N, DST) memcpy(DST, SRC, (N) * (W / 8))
+#define E_BULK_LE(W, SRC, N, DST) bswap ## W ## _n(SRC, N, DST)
+#elif defined(__BYTE_ORDER__)
+#define E_BULK_BE(W, SRC, N, DST) bswap ## W ## _n(SRC, N, DST)
+#define E_BULK_LE(W, SRC, N, DST) memcpy(DST, SRC, (N) * (W / 8))
+#endif
+
+#ifdef E_BULK_BE
+#define E_BULK(W, END, BULK) \
+	uint8_t * \
+	e :: pack ## W ## END ## _n(const uint ## W ## _t *numbers, size_t n, uint8_t *buffer) \
+	{ \
+		BULK(W, reinterpret_cast<const uint8_t *>(numbers), n, buffer); \
+		return buffer + n * sizeof(uint ## W ## _t); \
+	} \
+	const uint8_t * \
+	e :: unpack ## W ## END ## _n(const uint8_t *buffer, size_t n, uint ## W ## _t *numbers) \
+	{ \
+		BULK(W, buffer, n, reinterpret_cast<uint8_t *>(numbers)); \
+		return buffer + n * sizeof(uint ## W ## _t); \
+	}
+#else
+// Without a known host byte order, go a number at a time.
+#define E_BULK(W, END, BULK) \
+	uint8_t * \
+	e :: pack ## W ## END ## _n(const uint ## W ## _t *numbers, size_t n, uint8_t *buffer) \
+	{ \
+		for (size_t i = 0; i < n; ++i) \
+		{ \
+			buffer = pack ## W ## END(numbers[i], buffer); \
+		} \
+		return buffer; \
+	} \
+	const uint8_t * \
+	e :: unpack ## W ## END ## _n(const uint8_t *buffer, size_t n, uint ## W ## _t *numbers) \
+	{ \
+		for (size_t i = 0; i < n; ++i) \
+		{ \
+			buffer = unpack ## W ## END(buffer, numbers + i); \
+		} \
+		return buffer; \
+	}
+#endif
+
+E_BULK(32, be, E_BULK_BE)
+E_BULK(32, le, E_BULK_LE)
+E_BULK(64, be, E_BULK_BE)
+E_BULK(64, le, E_BULK_LE)
+
+#undef E_BULK
+#undef E_BULK_LE
+#undef E_BULK_BE
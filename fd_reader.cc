@@ -0,0 +1,220 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include "e/fd_reader.h"
+
+using e::fd_reader;
+using e::mapped_reader;
+
+namespace
+{
+
+// release consumed pages of a mapping in steps of at least this much
+const size_t RELEASE_STEP = 1048576;
+
+} // namespace
+
+fd_reader :: fd_reader(int fd)
+	: m_fd(fd)
+	, m_max_window(DEFAULT_MAX_WINDOW)
+	, m_buf(static_cast<uint8_t *>(malloc(DEFAULT_WINDOW)))
+	, m_cap(DEFAULT_WINDOW)
+	, m_start(0)
+	, m_end(0)
+	, m_eof(false)
+	, m_failed(false)
+	, m_error(0)
+{
+	if (!m_buf)
+	{
+		m_failed = true;
+		m_error = ENOMEM;
+	}
+}
+
+fd_reader :: fd_reader(int fd, size_t window, size_t max_window)
+	: m_fd(fd)
+	, m_max_window(std::max(window, max_window))
+	, m_buf(static_cast<uint8_t *>(malloc(std::max(window, size_t(1)))))
+	, m_cap(std::max(window, size_t(1)))
+	, m_start(0)
+	, m_end(0)
+	, m_eof(false)
+	, m_failed(false)
+	, m_error(0)
+{
+	if (!m_buf)
+	{
+		m_failed = true;
+		m_error = ENOMEM;
+	}
+}
+
+fd_reader :: ~fd_reader() throw ()
+{
+	free(m_buf);
+}
+
+bool
+fd_reader :: done()
+{
+	if (m_start == m_end && !m_eof && !m_failed)
+	{
+		refill();
+	}
+
+	return m_eof && m_start == m_end;
+}
+
+bool
+fd_reader :: refill()
+{
+	if (m_eof || m_error)
+	{
+		return false;
+	}
+
+	if (m_start > 0)
+	{
+		memmove(m_buf, m_buf + m_start, m_end - m_start);
+		m_end -= m_start;
+		m_start = 0;
+	}
+
+	if (m_end == m_cap)
+	{
+		const size_t cap = std::min(m_cap * 2, m_max_window);
+		uint8_t *buf = cap > m_cap ? static_cast<uint8_t *>(realloc(m_buf, cap)) : NULL;
+
+		if (!buf)
+		{
+			return false;
+		}
+
+		m_buf = buf;
+		m_cap = cap;
+	}
+
+	while (true)
+	{
+		ssize_t ret = read(m_fd, m_buf + m_end, m_cap - m_end);
+
+		if (ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (ret < 0)
+		{
+			m_error = errno;
+			return false;
+		}
+		else if (ret == 0)
+		{
+			m_eof = true;
+			return false;
+		}
+
+		m_end += ret;
+		return true;
+	}
+}
+
+mapped_reader :: mapped_reader(int fd)
+	: m_base(NULL)
+	, m_size(0)
+	, m_released(0)
+	, m_error(0)
+{
+	struct stat st;
+
+	if (fstat(fd, &st) < 0)
+	{
+		m_error = errno;
+		return;
+	}
+
+	if (st.st_size == 0)
+	{
+		return;
+	}
+
+	void *ptr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	if (ptr == MAP_FAILED)
+	{
+		m_error = errno;
+		return;
+	}
+
+	m_base = static_cast<uint8_t *>(ptr);
+	m_size = st.st_size;
+	madvise(m_base, m_size, MADV_SEQUENTIAL);
+}
+
+mapped_reader :: ~mapped_reader() throw ()
+{
+	if (m_base)
+	{
+		munmap(m_base, m_size);
+	}
+}
+
+e::unpacker
+mapped_reader :: unpack() const
+{
+	return e::unpacker(m_base, m_size);
+}
+
+void
+mapped_reader :: consumed(const e::unpacker &up)
+{
+	if (!m_base || up.error() || up.start() < m_base || up.start() > m_base + m_size)
+	{
+		return;
+	}
+
+	const size_t page = sysconf(_SC_PAGESIZE);
+	const size_t done = (up.start() - m_base) & ~(page - 1);
+
+	if (done >= m_released + RELEASE_STEP)
+	{
+		madvise(m_base + m_released, done - m_released, MADV_DONTNEED);
+		m_released = done;
+	}
+}
@@ -0,0 +1,324 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include "e/fd_writer.h"
+
+using e::fd_writer;
+
+namespace
+{
+
+// O_DIRECT transfers must be aligned to the logical block size; 4KB covers
+// every device we care about.
+const size_t BLOCK = 4096;
+
+} // namespace
+
+class fd_writer::bytes_manager : public e::packer::bytes_manager
+{
+public:
+	bytes_manager(fd_writer *w) : m_w(w) {}
+	virtual ~bytes_manager() throw () {}
+
+public:
+	virtual void write(size_t off, const uint8_t *ptr, size_t ptr_sz)
+	{ m_w->write(off, ptr, ptr_sz); }
+
+private:
+	fd_writer *m_w;
+
+private:
+	bytes_manager(const bytes_manager &);
+	bytes_manager &operator = (const bytes_manager &);
+};
+
+fd_writer :: fd_writer(int fd)
+	: m_fd(fd)
+	, m_options(0)
+	, m_cap(DEFAULT_STAGING)
+	, m_staging(NULL)
+	, m_used(0)
+	, m_base(0)
+	, m_origin(lseek(fd, 0, SEEK_CUR))
+	, m_direct(false)
+	, m_error(0)
+{
+	void *ptr = NULL;
+
+	if (posix_memalign(&ptr, BLOCK, m_cap) != 0)
+	{
+		m_error = ENOMEM;
+	}
+
+	m_staging = static_cast<uint8_t *>(ptr);
+}
+
+fd_writer :: fd_writer(int fd, size_t staging, unsigned options)
+	: m_fd(fd)
+	, m_options(options)
+	, m_cap(std::max(BLOCK, (staging + BLOCK - 1) & ~(BLOCK - 1)))
+	, m_staging(NULL)
+	, m_used(0)
+	, m_base(0)
+	, m_origin(lseek(fd, 0, SEEK_CUR))
+	, m_direct(false)
+	, m_error(0)
+{
+	void *ptr = NULL;
+
+	if (posix_memalign(&ptr, BLOCK, m_cap) != 0)
+	{
+		m_error = ENOMEM;
+	}
+
+	m_staging = static_cast<uint8_t *>(ptr);
+
+	if ((m_options & DIRECT) && m_origin >= 0 &&
+	    static_cast<uint64_t>(m_origin) % BLOCK == 0)
+	{
+		set_direct(true);
+	}
+}
+
+fd_writer :: ~fd_writer() throw ()
+{
+	if (!m_error)
+	{
+		flush();
+	}
+
+	free(m_staging);
+}
+
+e::packer
+fd_writer :: pack()
+{
+	e::compat::shared_ptr<e::packer::bytes_manager> mgr(new bytes_manager(this));
+	return e::packer(mgr, size());
+}
+
+void
+fd_writer :: write(size_t off, const uint8_t *ptr, size_t ptr_sz)
+{
+	while (!m_error && size() < off)
+	{
+		static const uint8_t zeros[64] = {0};
+		append(zeros, std::min(sizeof(zeros), static_cast<size_t>(off - size())));
+	}
+
+	if (!m_error && off < size())
+	{
+		const size_t overlap = std::min(ptr_sz, static_cast<size_t>(size() - off));
+		patch(off, ptr, overlap);
+		ptr += overlap;
+		ptr_sz -= overlap;
+	}
+
+	append(ptr, ptr_sz);
+}
+
+bool
+fd_writer :: flush()
+{
+	if (m_error)
+	{
+		return false;
+	}
+
+	if (m_direct && m_used % BLOCK != 0)
+	{
+		set_direct(false);
+	}
+
+	flush_staging();
+	return !m_error;
+}
+
+bool
+fd_writer :: sync()
+{
+	if (!flush())
+	{
+		return false;
+	}
+
+	if (fsync(m_fd) < 0)
+	{
+		m_error = errno;
+		return false;
+	}
+
+	return true;
+}
+
+void
+fd_writer :: append(const uint8_t *ptr, size_t sz)
+{
+	while (!m_error && sz > 0)
+	{
+		// large writes skip the copy when nothing is staged and alignment
+		// does not matter
+		if (m_used == 0 && sz >= m_cap && !m_direct)
+		{
+			write_out(ptr, sz);
+			m_base += sz;
+			return;
+		}
+
+		const size_t x = std::min(sz, m_cap - m_used);
+		memmove(m_staging + m_used, ptr, x);
+		m_used += x;
+		ptr += x;
+		sz -= x;
+
+		if (m_used == m_cap)
+		{
+			flush_staging();
+		}
+	}
+}
+
+void
+fd_writer :: patch(uint64_t off, const uint8_t *ptr, size_t sz)
+{
+	if (off < m_base)
+	{
+		const size_t x = std::min(sz, static_cast<size_t>(m_base - off));
+		const bool direct = m_direct;
+
+		if (m_origin < 0)
+		{
+			m_error = ESPIPE;
+			return;
+		}
+
+		if (direct)
+		{
+			set_direct(false);
+		}
+
+		for (size_t done = 0; done < x; )
+		{
+			ssize_t ret = pwrite(m_fd, ptr + done, x - done, m_origin + off + done);
+
+			if (ret < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else if (ret <= 0)
+			{
+				m_error = ret < 0 ? errno : EIO;
+				break;
+			}
+
+			done += ret;
+		}
+
+		if (direct)
+		{
+			set_direct(true);
+		}
+
+		off += x;
+		ptr += x;
+		sz -= x;
+	}
+
+	if (!m_error && sz > 0)
+	{
+		memmove(m_staging + (off - m_base), ptr, sz);
+	}
+}
+
+void
+fd_writer :: write_out(const uint8_t *ptr, size_t sz)
+{
+	while (!m_error && sz > 0)
+	{
+		ssize_t ret = ::write(m_fd, ptr, sz);
+
+		if (ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (ret <= 0)
+		{
+			m_error = ret < 0 ? errno : EIO;
+			break;
+		}
+
+		ptr += ret;
+		sz -= ret;
+	}
+
+	if (!m_error && (m_options & SYNC) && fdatasync(m_fd) < 0)
+	{
+		m_error = errno;
+	}
+}
+
+void
+fd_writer :: flush_staging()
+{
+	if (m_used > 0)
+	{
+		write_out(m_staging, m_used);
+		m_base += m_used;
+		m_used = 0;
+	}
+}
+
+void
+fd_writer :: set_direct(bool on)
+{
+#ifdef O_DIRECT
+	const int flags = fcntl(m_fd, F_GETFL);
+
+	if (flags < 0)
+	{
+		return;
+	}
+
+	if (fcntl(m_fd, F_SETFL, on ? flags | O_DIRECT : flags & ~O_DIRECT) == 0)
+	{
+		m_direct = on;
+	}
+#else
+	(void) on;
+#endif
+}
@@ -0,0 +1,375 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <string.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include "e/endian.h"
+#include "e/group_varint.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define E_VBYTE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+typedef const uint8_t *(*group_kernel)(const uint8_t *p, const uint8_t *limit,
+                                       uint32_t *out, size_t n);
+typedef const uint8_t *(*stream_kernel)(const uint8_t *ctrl, const uint8_t *data,
+                                        const uint8_t *limit, uint32_t *out, size_t n);
+
+inline unsigned
+code(uint32_t x)
+{
+	return (31 - __builtin_clz(x | 1)) >> 3;
+}
+
+inline uint8_t *
+put(uint32_t x, unsigned len, uint8_t *dst)
+{
+	uint8_t tmp[sizeof(uint32_t)];
+	e::pack32le(x, tmp);
+	memcpy(dst, tmp, len);
+	return dst + len;
+}
+
+// The control byte for the k <= 4 values at v.
+inline unsigned
+control(const uint32_t *v, size_t k)
+{
+	unsigned c = 0;
+
+	for (size_t j = 0; j < k; ++j)
+	{
+		c |= code(v[j]) << (2 * j);
+	}
+
+	return c;
+}
+
+// The data bytes for the values at v[0..n).
+inline uint8_t *
+put_n(const uint32_t *v, size_t n, uint8_t *dst)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		dst = put(v[i], code(v[i]) + 1, dst);
+	}
+
+	return dst;
+}
+
+inline uint32_t
+get(const uint8_t *p, unsigned len)
+{
+	uint8_t tmp[sizeof(uint32_t)] = {0, 0, 0, 0};
+	uint32_t x;
+	memcpy(tmp, p, len);
+	e::unpack32le(tmp, &x);
+	return x;
+}
+
+// Decode the k <= 4 values described by "ctrl" from [data, limit).
+inline const uint8_t *
+decode_group(unsigned ctrl, const uint8_t *data, const uint8_t *limit,
+             uint32_t *out, size_t k)
+{
+	for (size_t j = 0; j < k; ++j)
+	{
+		const unsigned len = ((ctrl >> (2 * j)) & 3) + 1;
+
+		if (static_cast<size_t>(limit - data) < len)
+		{
+			return NULL;
+		}
+
+		out[j] = get(data, len);
+		data += len;
+	}
+
+	return data;
+}
+
+const uint8_t *
+group_decode_scalar(const uint8_t *p, const uint8_t *limit, uint32_t *out, size_t n)
+{
+	for (size_t i = 0; i < n; i += 4)
+	{
+		if (p >= limit)
+		{
+			return NULL;
+		}
+
+		const unsigned ctrl = *p;
+		p = decode_group(ctrl, p + 1, limit, out + i, n - i < 4 ? n - i : 4);
+
+		if (!p)
+		{
+			return NULL;
+		}
+	}
+
+	return p;
+}
+
+const uint8_t *
+stream_decode_scalar(const uint8_t *ctrl, const uint8_t *data,
+                     const uint8_t *limit, uint32_t *out, size_t n)
+{
+	for (size_t i = 0; i < n; i += 4)
+	{
+		data = decode_group(*ctrl++, data, limit, out + i, n - i < 4 ? n - i : 4);
+
+		if (!data)
+		{
+			return NULL;
+		}
+	}
+
+	return data;
+}
+
+#ifdef E_VBYTE_X86
+
+// For every control byte, the pshufb mask that moves its four values'
+// bytes into four zero-extended 32-bit lanes, and the bytes they occupy.
+// Filled by choose_kernels() before it selects the SSSE3 kernels.
+uint8_t shuffle_mask[256][16];
+uint8_t shuffle_length[256];
+
+void
+fill_shuffle_tables()
+{
+	for (unsigned c = 0; c < 256; ++c)
+	{
+		unsigned off = 0;
+
+		for (unsigned j = 0; j < 4; ++j)
+		{
+			const unsigned len = ((c >> (2 * j)) & 3) + 1;
+
+			for (unsigned b = 0; b < 4; ++b)
+			{
+				shuffle_mask[c][j * 4 + b] = b < len ? off + b : 0x80;
+			}
+
+			off += len;
+		}
+
+		shuffle_length[c] = off;
+	}
+}
+
+__attribute__ ((target ("ssse3")))
+inline void
+shuffle_group(unsigned ctrl, const uint8_t *data, uint32_t *out)
+{
+	const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+	const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffle_mask[ctrl]));
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(x, m));
+}
+
+__attribute__ ((target ("ssse3")))
+const uint8_t *
+group_decode_ssse3(const uint8_t *p, const uint8_t *limit, uint32_t *out, size_t n)
+{
+	size_t i = 0;
+
+	// a full 16-byte load must stay within the input
+	for (; i + 4 <= n && limit - p >= 17; i += 4)
+	{
+		const unsigned ctrl = *p;
+		shuffle_group(ctrl, p + 1, out + i);
+		p += 1 + shuffle_length[ctrl];
+	}
+
+	return group_decode_scalar(p, limit, out + i, n - i);
+}
+
+__attribute__ ((target ("ssse3")))
+const uint8_t *
+stream_decode_ssse3(const uint8_t *ctrl, const uint8_t *data,
+                    const uint8_t *limit, uint32_t *out, size_t n)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= n && limit - data >= 16; i += 4)
+	{
+		shuffle_group(*ctrl, data, out + i);
+		data += shuffle_length[*ctrl];
+		++ctrl;
+	}
+
+	return stream_decode_scalar(ctrl, data, limit, out + i, n - i);
+}
+
+#endif // E_VBYTE_X86
+
+struct kernels
+{
+	group_kernel group;
+	stream_kernel stream;
+};
+
+kernels
+choose_kernels()
+{
+	kernels k;
+	k.group = group_decode_scalar;
+	k.stream = stream_decode_scalar;
+#ifdef E_VBYTE_X86
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("ssse3"))
+	{
+		fill_shuffle_tables();
+		k.group = group_decode_ssse3;
+		k.stream = stream_decode_ssse3;
+	}
+#endif // E_VBYTE_X86
+	return k;
+}
+
+// Chosen on first use, so decoding from another translation unit's static
+// initializers gets the right kernels and the tables are ready in time.
+const kernels &
+select_kernels()
+{
+	static const kernels k = choose_kernels();
+	return k;
+}
+
+} // namespace
+
+size_t
+e :: group_varint_length(const uint32_t *v, size_t n)
+{
+	size_t sz = (n + 3) / 4;
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		sz += code(v[i]) + 1;
+	}
+
+	return sz;
+}
+
+uint8_t *
+e :: group_varint_encode(uint8_t *dst, const uint32_t *v, size_t n)
+{
+	for (size_t i = 0; i < n; i += 4)
+	{
+		const size_t k = n - i < 4 ? n - i : 4;
+		*dst++ = control(v + i, k);
+		dst = put_n(v + i, k, dst);
+	}
+
+	return dst;
+}
+
+uint8_t *
+e :: stream_vbyte_encode(uint8_t *dst, const uint32_t *v, size_t n)
+{
+	uint8_t *ctrl = dst;
+	dst += (n + 3) / 4;
+
+	for (size_t i = 0; i < n; i += 4)
+	{
+		const size_t k = n - i < 4 ? n - i : 4;
+		*ctrl++ = control(v + i, k);
+	}
+
+	return put_n(v, n, dst);
+}
+
+e::packer
+e :: pack_vbytes(packer pa, const uint32_t *v, size_t n, vbyte_format fmt)
+{
+	// a multiple of four, so chunks split the encoding between groups
+	const size_t CHUNK = 512;
+	uint8_t buf[CHUNK / 4 + CHUNK * sizeof(uint32_t)];
+	packer out = pa << pack_varint(n);
+
+	if (fmt == GROUP_VARINT)
+	{
+		for (size_t i = 0; i < n; i += CHUNK)
+		{
+			const size_t k = std::min(CHUNK, n - i);
+			out.append(buf, group_varint_encode(buf, v + i, k) - buf, &out);
+		}
+
+		return out;
+	}
+
+	// every control byte, then every value's data
+	for (size_t i = 0; i < n; i += CHUNK)
+	{
+		const size_t k = std::min(CHUNK, n - i);
+
+		for (size_t g = 0; g < k; g += 4)
+		{
+			buf[g / 4] = control(v + i + g, k - g < 4 ? k - g : 4);
+		}
+
+		out.append(buf, (k + 3) / 4, &out);
+	}
+
+	for (size_t i = 0; i < n; i += CHUNK)
+	{
+		const size_t k = std::min(CHUNK, n - i);
+		out.append(buf, put_n(v + i, k, buf) - buf, &out);
+	}
+
+	return out;
+}
+
+const uint8_t *
+e :: group_varint_decode(const uint8_t *p, const uint8_t *limit, uint32_t *out, size_t n)
+{
+	return select_kernels().group(p, limit, out, n);
+}
+
+const uint8_t *
+e :: stream_vbyte_decode(const uint8_t *p, const uint8_t *limit, uint32_t *out, size_t n)
+{
+	const size_t ctrl_sz = (n + 3) / 4;
+
+	if (static_cast<size_t>(limit - p) < ctrl_sz)
+	{
+		return NULL;
+	}
+
+	return select_kernels().stream(p, p + ctrl_sz, limit, out, n);
+}
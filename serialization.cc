@@ -29,6 +29,10 @@
 
 // C
 #include <stdint.h>
+#include <string.h>
+
+// STL
+#include <algorithm>
 
 // e
 #include "e/buffer.h"
@@ -54,20 +58,29 @@ struct string_bytes_manager : public e::packer::bytes_manager
 	virtual void write(size_t off, const uint8_t *_ptr, size_t ptr_sz)
 	{
 		const char *ptr = reinterpret_cast<const char *>(_ptr);
-		if (m_str->size() < off)
+		const size_t new_size = std::max(m_str->size(), off + ptr_sz);
+
+		// grow geometrically so that appends stay amortized O(1) even when
+		// the string was sized exactly by a previous write
+		if (new_size > m_str->capacity())
 		{
-			m_str->resize(off, '\0');
+			m_str->reserve(std::max(new_size, m_str->capacity() * 2));
 		}
-		assert(m_str->size() >= off);
-		if (m_str->size() == off)
+
+		if (m_str->size() < off)
 		{
-			m_str->append(ptr, ptr_sz);
+			m_str->resize(off, '\0');
 		}
-		else
+
+		// overwrite whatever overlaps in place and append the rest
+		const size_t overlap = std::min(ptr_sz, m_str->size() - off);
+
+		if (overlap > 0)
 		{
-			const size_t end = std::min(off + ptr_sz, m_str->size());
-			m_str->replace(off, end, ptr, ptr_sz);
+			memmove(&(*m_str)[off], ptr, overlap);
 		}
+
+		m_str->append(ptr + overlap, ptr_sz - overlap);
 	}
 
 private:
@@ -105,6 +118,58 @@ private:
 	buffer_bytes_manager &operator = (const buffer_bytes_manager &);
 };
 
+struct growable_buffer_bytes_manager : public e::packer::bytes_manager
+{
+	growable_buffer_bytes_manager(e::buffer **buf) : m_buf(buf) {}
+	virtual ~growable_buffer_bytes_manager() throw () {}
+
+	virtual void write(size_t off, const uint8_t *ptr, size_t ptr_sz)
+	{
+		const size_t new_size = off + ptr_sz;
+		const size_t cap = *m_buf ? (*m_buf)->capacity() : 0;
+
+		if (new_size > cap)
+		{
+			grow(std::max(new_size, cap * 2));
+		}
+
+		if ((*m_buf)->size() < off)
+		{
+			memset((*m_buf)->data() + (*m_buf)->size(), 0, off - (*m_buf)->size());
+		}
+
+		memmove((*m_buf)->data() + off, ptr, ptr_sz);
+
+		if ((*m_buf)->size() < new_size)
+		{
+			(*m_buf)->resize(new_size);
+		}
+	}
+
+private:
+	void grow(size_t cap)
+	{
+		e::buffer *old = *m_buf;
+		e::buffer *buf = e::buffer::create(std::max(cap, size_t(64)));
+
+		if (old)
+		{
+			memmove(buf->data(), old->data(), old->size());
+			buf->resize(old->size());
+			delete old;
+		}
+
+		*m_buf = buf;
+	}
+
+private:
+	e::buffer **m_buf;
+
+private:
+	growable_buffer_bytes_manager(const growable_buffer_bytes_manager &);
+	growable_buffer_bytes_manager &operator = (const growable_buffer_bytes_manager &);
+};
+
 } // namespace
 
 packer :: bytes_manager :: bytes_manager()
@@ -115,6 +180,12 @@ packer :: bytes_manager :: ~bytes_manager() throw ()
 {
 }
 
+void
+packer :: bytes_manager :: reference(size_t off, const uint8_t *ptr, size_t ptr_sz)
+{
+	write(off, ptr, ptr_sz);
+}
+
 packer :: packer(std::string *str)
 	: m_mgr(new string_bytes_manager(str))
 	, m_off(0)
@@ -133,6 +204,12 @@ packer :: packer(e::buffer *buf, size_t off)
 {
 }
 
+packer :: packer(e::buffer **buf, size_t off)
+	: m_mgr(new growable_buffer_bytes_manager(buf))
+	, m_off(off)
+{
+}
+
 packer :: packer(const packer &other)
 	: m_mgr(other.m_mgr)
 	, m_off(other.m_off)
@@ -143,6 +220,15 @@ packer :: ~packer() throw ()
 {
 }
 
+packer &
+packer :: operator = (const packer &rhs)
+{
+	// no self assign check needed
+	m_mgr = rhs.m_mgr;
+	m_off = rhs.m_off;
+	return *this;
+}
+
 void
 packer :: append(const uint8_t *ptr, size_t ptr_sz, packer *pa)
 {
@@ -154,6 +240,18 @@ packer :: append(const uint8_t *ptr, size_t ptr_sz, packer *pa)
 	*pa = packer(m_mgr, m_off + ptr_sz);
 }
 
+void
+packer :: reference(const uint8_t *ptr, size_t ptr_sz, packer *pa)
+{
+	if (SIZE_MAX - m_off < ptr_sz)
+	{
+		abort();
+	}
+	m_mgr->reference(m_off, ptr, ptr_sz);
+	pa->m_mgr = m_mgr;
+	pa->m_off = m_off + ptr_sz;
+}
+
 packer :: packer(e::compat::shared_ptr<bytes_manager> mgr, size_t off)
 	: m_mgr(mgr)
 	, m_off(off)
@@ -235,6 +333,82 @@ unpacker :: operator = (const unpacker &rhs)
 	return *this;
 }
 
+namespace
+{
+
+// Vectors of fixed-width integers are byte-swapped in bulk through a stack
+// buffer rather than one element at a time.
+const size_t BULK_BYTES = 4096;
+
+template <typename T>
+packer
+pack_bulk(const packer &start, const std::vector<T> &rhs,
+          uint8_t *(*pack)(const T *src, size_t n, uint8_t *dst))
+{
+	uint8_t buf[BULK_BYTES];
+	const size_t step = BULK_BYTES / sizeof(T);
+	packer pa = start << e::pack_varint(rhs.size());
+
+	for (size_t i = 0; i < rhs.size(); i += step)
+	{
+		const size_t n = std::min(step, rhs.size() - i);
+		pack(&rhs[i], n, buf);
+		pa.append(buf, n * sizeof(T), &pa);
+	}
+
+	return pa;
+}
+
+template <typename T>
+unpacker
+unpack_bulk(unpacker up, std::vector<T> &rhs,
+            const uint8_t *(*unpack)(const uint8_t *src, size_t n, T *dst))
+{
+	uint64_t sz = 0;
+	up = up >> e::unpack_varint(sz);
+	rhs.clear();
+
+	if (up.error() || sz > up.remain() / sizeof(T))
+	{
+		return unpacker::error_out();
+	}
+
+	rhs.resize(sz);
+
+	if (sz > 0)
+	{
+		unpack(up.start(), sz, &rhs[0]);
+	}
+
+	return up.advance(sz * sizeof(T));
+}
+
+} // namespace
+
+packer
+packer :: operator << (const std::vector<uint32_t> &rhs)
+{
+	return pack_bulk(*this, rhs, e::pack32be_n);
+}
+
+packer
+packer :: operator << (const std::vector<uint64_t> &rhs)
+{
+	return pack_bulk(*this, rhs, e::pack64be_n);
+}
+
+unpacker
+unpacker :: operator >> (std::vector<uint32_t> &rhs)
+{
+	return unpack_bulk(*this, rhs, e::unpack32be_n);
+}
+
+unpacker
+unpacker :: operator >> (std::vector<uint64_t> &rhs)
+{
+	return unpack_bulk(*this, rhs, e::unpack64be_n);
+}
+
 #define PACKER(TYPE, PACKF) \
 	packer \
 	e :: operator << (packer pa, const TYPE& rhs) \
@@ -292,7 +466,9 @@ e :: pack_size(const e::slice &s)
 packer
 e :: operator << (packer pa, const e::slice &rhs)
 {
-	return pa << pack_varint(rhs.size()) << pack_memmove(rhs.data(), rhs.size());
+	packer ret = pa << pack_varint(rhs.size());
+	ret.reference(rhs.data(), rhs.size(), &ret);
+	return ret;
 }
 
 unpacker
@@ -0,0 +1,167 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <assert.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include "e/shared_buffer.h"
+
+using e::shared_buffer;
+using e::shared_slice;
+
+shared_buffer::ref
+shared_buffer :: create(const char *buf, size_t sz)
+{
+	return adopt(e::buffer::create(buf, sz));
+}
+
+shared_buffer::ref
+shared_buffer :: adopt(e::buffer *buf)
+{
+	assert(buf);
+	return ref(new shared_buffer(buf));
+}
+
+shared_slice
+shared_buffer :: slice(size_t off, size_t sz) const
+{
+	return shared_slice(ref(const_cast<shared_buffer *>(this)), off, sz);
+}
+
+shared_buffer :: shared_buffer(e::buffer *buf)
+	: m_ref(0)
+	, m_buf(buf)
+{
+}
+
+shared_buffer :: ~shared_buffer() throw ()
+{
+	delete m_buf;
+}
+
+shared_slice :: shared_slice()
+	: m_buf()
+	, m_data(NULL)
+	, m_sz(0)
+{
+}
+
+shared_slice :: shared_slice(const shared_buffer::ref &buf)
+	: m_buf(buf)
+	, m_data(buf->data())
+	, m_sz(buf->size())
+{
+}
+
+shared_slice :: shared_slice(const shared_buffer::ref &buf, size_t off, size_t sz)
+	: m_buf(buf)
+	, m_data(NULL)
+	, m_sz(0)
+{
+	off = std::min(off, buf->size());
+	m_data = buf->data() + off;
+	m_sz = std::min(sz, buf->size() - off);
+}
+
+shared_slice :: shared_slice(const shared_buffer::ref &buf, const e::slice &s)
+	: m_buf(buf)
+	, m_data(s.data())
+	, m_sz(s.size())
+{
+	assert(s.data() >= buf->data());
+	assert(s.data() + s.size() <= buf->data() + buf->size());
+}
+
+shared_slice :: shared_slice(const shared_slice &other)
+	: m_buf(other.m_buf)
+	, m_data(other.m_data)
+	, m_sz(other.m_sz)
+{
+}
+
+shared_slice :: ~shared_slice() throw ()
+{
+}
+
+shared_slice
+shared_slice :: sub(size_t off, size_t sz) const
+{
+	shared_slice ret(*this);
+	off = std::min(off, m_sz);
+	ret.m_data = m_data + off;
+	ret.m_sz = std::min(sz, m_sz - off);
+	return ret;
+}
+
+shared_slice &
+shared_slice :: operator = (const shared_slice &rhs)
+{
+	m_buf = rhs.m_buf;
+	m_data = rhs.m_data;
+	m_sz = rhs.m_sz;
+	return *this;
+}
+
+size_t
+e :: pack_size(const shared_slice &s)
+{
+	return pack_size(s.as_slice());
+}
+
+e::packer
+e :: operator << (e::packer pa, const shared_slice &x)
+{
+	return pa << x.as_slice();
+}
+
+e::unpacker
+e :: operator >> (e::unpacker up, const unpack_shared &x)
+{
+	e::slice s;
+	up = up >> s;
+
+	if (up.error())
+	{
+		return up;
+	}
+
+	const uint8_t *lower = x.buf->data();
+	const uint8_t *upper = lower + x.buf->size();
+
+	if (s.data() < lower || s.data() + s.size() > upper)
+	{
+		return e::unpacker::error_out();
+	}
+
+	x.s = shared_slice(x.buf, s);
+	return up;
+}
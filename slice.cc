@@ -26,12 +26,17 @@
 // POSSIBILITY OF SUCH DAMAGE.
 
 // STL
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
 // e
 #include "e/slice.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using e::slice;
 
 slice :: slice()
@@ -97,6 +102,70 @@ slice :: compare(const slice &rhs) const
 	}
 }
 
+int
+slice :: lexicographic_compare(const slice &rhs) const
+{
+	const size_t sz = std::min(m_sz, rhs.m_sz);
+	const int cmp = sz > 0 ? memcmp(m_data, rhs.m_data, sz) : 0;
+
+	if (cmp != 0)
+	{
+		return cmp;
+	}
+
+	return m_sz < rhs.m_sz ? -1 : m_sz > rhs.m_sz ? 1 : 0;
+}
+
+size_t
+slice :: common_prefix_length(const slice &rhs) const
+{
+	const size_t sz = std::min(m_sz, rhs.m_sz);
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 16 <= sz; i += 16)
+	{
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_data + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs.m_data + i));
+		const unsigned diff = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xffffU;
+
+		if (diff)
+		{
+			return i + __builtin_ctz(diff);
+		}
+	}
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	for (; i + 8 <= sz; i += 8)
+	{
+		uint64_t a;
+		uint64_t b;
+		memcpy(&a, m_data + i, 8);
+		memcpy(&b, rhs.m_data + i, 8);
+
+		if (a != b)
+		{
+			return i + __builtin_ctzll(a ^ b) / 8;
+		}
+	}
+#endif
+
+	while (i < sz && m_data[i] == rhs.m_data[i])
+	{
+		++i;
+	}
+
+	return i;
+}
+
+bool
+slice :: equals(const slice &rhs) const
+{
+	return m_sz == rhs.m_sz &&
+	       (m_sz == 0 || memcmp(m_data, rhs.m_data, m_sz) == 0);
+}
+
 std::string
 slice :: hex() const
 {
@@ -114,7 +183,7 @@ bool
 slice :: starts_with(const e::slice &prefix) const
 {
 	return size() >= prefix.size() &&
-	       memcmp(data(), prefix.data(), prefix.size()) == 0;
+	       (prefix.empty() || memcmp(data(), prefix.data(), prefix.size()) == 0);
 }
 
 void
@@ -0,0 +1,310 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// e
+#include "th.h"
+#include "e/arena.h"
+#include "e/arena_chunk_source.h"
+
+namespace
+{
+
+TEST(ArenaTest, BumpWithinChunk)
+{
+	e::arena a(64, 1024);
+	unsigned char *x = NULL;
+	unsigned char *y = NULL;
+	a.allocate(16, &x);
+	a.allocate(16, &y);
+	ASSERT_TRUE(x != NULL);
+	ASSERT_TRUE(y == x + 16);
+	memset(x, 'x', 32);
+}
+
+TEST(ArenaTest, NewChunkOnOverflow)
+{
+	e::arena a(64, 1024);
+	unsigned char *ptrs[16];
+	for (size_t i = 0; i < 16; ++i)
+	{
+		a.allocate(24, &ptrs[i]);
+		ASSERT_TRUE(ptrs[i] != NULL);
+		memset(ptrs[i], i, 24);
+	}
+	// the first chunk holds two objects; the second (128B) holds five
+	ASSERT_TRUE(ptrs[1] == ptrs[0] + 24);
+	ASSERT_TRUE(ptrs[3] == ptrs[2] + 24);
+	ASSERT_TRUE(ptrs[6] == ptrs[5] + 24);
+	for (size_t i = 0; i < 16; ++i)
+	{
+		for (size_t j = 0; j < 24; ++j)
+		{
+			ASSERT_EQ(i, ptrs[i][j]);
+		}
+	}
+}
+
+TEST(ArenaTest, LargeAllocationKeepsChunk)
+{
+	e::arena a(64, 128);
+	unsigned char *x = NULL;
+	unsigned char *big = NULL;
+	unsigned char *y = NULL;
+	a.allocate(8, &x);
+	a.allocate(1000, &big);
+	a.allocate(8, &y);
+	ASSERT_TRUE(big != NULL);
+	memset(big, 0, 1000);
+	ASSERT_TRUE(y == x + 8);
+}
+
+TEST(ArenaTest, ChunkingDisabled)
+{
+	e::arena a(0, 0);
+	unsigned char *x = NULL;
+	unsigned char *y = NULL;
+	a.reserve(32);
+	a.allocate(16, &x);
+	a.allocate(16, &y);
+	ASSERT_TRUE(y == x + 16);
+	a.allocate(16, &x);
+	a.allocate(16, &y);
+	ASSERT_TRUE(x != NULL);
+	ASSERT_TRUE(y != NULL);
+	memset(x, 0, 16);
+	memset(y, 0, 16);
+}
+
+TEST(ArenaTest, Aligned)
+{
+	e::arena a(64, 1024);
+	unsigned char *ptr = NULL;
+	a.allocate(3, &ptr);
+
+	for (size_t align = 1; align <= 256; align *= 2)
+	{
+		a.allocate(5, align, &ptr);
+		ASSERT_TRUE(ptr != NULL);
+		ASSERT_EQ(0U, reinterpret_cast<uintptr_t>(ptr) & (align - 1));
+		memset(ptr, 0, 5);
+	}
+
+	uint64_t *u = a.allocate<uint64_t>(100);
+	ASSERT_TRUE(u != NULL);
+	ASSERT_EQ(0U, reinterpret_cast<uintptr_t>(u) & (__alignof__(uint64_t) - 1));
+	memset(u, 0, 100 * sizeof(uint64_t));
+	ASSERT_TRUE(a.allocate<uint64_t>(static_cast<size_t>(-1) / 4) == NULL);
+}
+
+class tracked
+{
+public:
+	tracked(int *order, int *next, int tag)
+		: m_order(order), m_next(next), m_tag(tag) {}
+	~tracked() throw () { m_order[(*m_next)++] = m_tag; }
+
+private:
+	tracked(const tracked &);
+	tracked &operator = (const tracked &);
+
+private:
+	int *m_order;
+	int *m_next;
+	int m_tag;
+};
+
+TEST(ArenaTest, ConstructAndDestroy)
+{
+	int storage[4] = {0, 0, 0, 0};
+	int *order = storage;
+	int next = 0;
+
+	{
+		e::arena a(64, 1024);
+		ASSERT_TRUE(a.construct<tracked>(order, &next, 1) != NULL);
+		ASSERT_TRUE(a.construct<tracked>(order, &next, 2) != NULL);
+		a.clear();
+		ASSERT_EQ(2, next);
+		ASSERT_EQ(2, order[0]);
+		ASSERT_EQ(1, order[1]);
+		ASSERT_TRUE(a.construct<tracked>(order, &next, 3) != NULL);
+		ASSERT_TRUE(a.construct<tracked>(order, &next, 4) != NULL);
+	}
+
+	ASSERT_EQ(4, next);
+	ASSERT_EQ(4, order[2]);
+	ASSERT_EQ(3, order[3]);
+}
+
+TEST(ArenaTest, ResetKeepsLargestChunk)
+{
+	e::arena a(64, 1024);
+	unsigned char *first = NULL;
+	unsigned char *ptr = NULL;
+
+	for (size_t i = 0; i < 16; ++i)
+	{
+		a.allocate(48, &ptr);
+	}
+
+	a.allocate(400, &first);
+	ASSERT_TRUE(first != NULL);
+	ASSERT_LE(448U, a.retained());
+
+	// chunks of 64, 128, 256, 512 hold the small objects; 1024 the large one
+	a.reset();
+	ASSERT_EQ(1024U, a.retained());
+	a.allocate(8, &ptr);
+	ASSERT_TRUE(ptr == first);
+	unsigned char *second = NULL;
+	a.allocate(8, &second);
+	ASSERT_TRUE(second == ptr + 8);
+	memset(ptr, 0, 1024);
+
+	a.clear();
+	ASSERT_EQ(0U, a.retained());
+}
+
+TEST(ArenaTest, ResetRetainsUpTo)
+{
+	e::arena a(64, 1024);
+	unsigned char *ptr = NULL;
+
+	for (size_t i = 0; i < 64; ++i)
+	{
+		a.allocate(60, &ptr);
+	}
+
+	const size_t before = a.retained();
+	a.reset(before);
+	ASSERT_EQ(before, a.retained());
+
+	for (size_t i = 0; i < 64; ++i)
+	{
+		a.allocate(60, &ptr);
+		memset(ptr, 0, 60);
+	}
+
+	ASSERT_EQ(before, a.retained());
+	a.reset(700);
+	ASSERT_LE(a.retained(), 700U);
+}
+
+TEST(ArenaTest, ResetRunsDestructors)
+{
+	int storage[2] = {0, 0};
+	int *order = storage;
+	int next = 0;
+	e::arena a(64, 1024);
+	ASSERT_TRUE(a.construct<tracked>(order, &next, 1) != NULL);
+	a.reset();
+	ASSERT_EQ(1, next);
+	ASSERT_EQ(1, order[0]);
+}
+
+TEST(ArenaTest, Statistics)
+{
+	e::arena::stats before;
+	e::arena::global_statistics(&before);
+
+	{
+		e::arena a(64, 256);
+		unsigned char *ptr = NULL;
+		a.allocate(40, &ptr);
+		a.allocate(40, &ptr);
+		a.allocate(500, &ptr);
+		a.takeover(static_cast<unsigned char *>(malloc(1)));
+
+		e::arena::stats s;
+		a.statistics(&s);
+		ASSERT_EQ(64U + 128U + 500U, s.bytes_reserved);
+		ASSERT_EQ(580U, s.bytes_used);
+		ASSERT_EQ(2U, s.chunks);
+		ASSERT_EQ(1U, s.fallbacks);
+		ASSERT_EQ(1U, s.takeovers);
+		ASSERT_EQ(692U, s.peak_reserved);
+
+		a.reset();
+		a.statistics(&s);
+		ASSERT_EQ(128U, s.bytes_reserved);
+		ASSERT_EQ(0U, s.bytes_used);
+		ASSERT_EQ(580U, s.peak_used);
+		ASSERT_EQ(692U, s.peak_reserved);
+	}
+
+	e::arena::stats after;
+	e::arena::global_statistics(&after);
+	ASSERT_EQ(before.bytes_reserved, after.bytes_reserved);
+	ASSERT_EQ(before.bytes_used + 580U, after.bytes_used);
+	ASSERT_EQ(before.chunks + 2U, after.chunks);
+	ASSERT_EQ(before.fallbacks + 1U, after.fallbacks);
+	ASSERT_EQ(before.takeovers + 1U, after.takeovers);
+	ASSERT_LE(692U, after.peak_reserved);
+	ASSERT_LE(580U, after.peak_used);
+}
+
+TEST(ArenaTest, MmapChunkSource)
+{
+	e::mmap_chunk_source source(false, true);
+	e::arena a(64, 1 << 20, &source);
+	unsigned char *x = NULL;
+	unsigned char *y = NULL;
+	unsigned char *big = NULL;
+	a.allocate(8, &x);
+	a.allocate(8, &y);
+	ASSERT_TRUE(y == x + 8);
+	// the first chunk was rounded up to a whole page
+	ASSERT_EQ(0U, a.retained() % 4096);
+	a.allocate(4 << 20, &big);
+	memset(big, 'b', 4 << 20);
+	memset(x, 'x', 8);
+	a.reset();
+	a.allocate(8, &y);
+	ASSERT_TRUE(y == x);
+	// released with MADV_DONTNEED, so the page reads back as zero
+	ASSERT_EQ(0, y[0]);
+}
+
+TEST(ArenaTest, HugePageChunkSource)
+{
+	e::mmap_chunk_source source(true, false);
+	e::arena a(1 << 20, 1 << 24, &source);
+	unsigned char *x = NULL;
+	a.allocate(8, &x);
+	ASSERT_TRUE(x != NULL);
+	ASSERT_EQ(0U, reinterpret_cast<uintptr_t>(x) % (2 << 20));
+	ASSERT_EQ(2U << 20, a.retained());
+	memset(x, 0, 2 << 20);
+}
+
+} // namespace
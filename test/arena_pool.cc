@@ -0,0 +1,147 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <pthread.h>
+#include <stdlib.h>
+
+// e
+#include "th.h"
+#include "e/arena_chunk_source.h"
+#include "e/arena_pool.h"
+
+namespace
+{
+
+TEST(ArenaPoolTest, HitsAndMisses)
+{
+	e::arena_pool pool(2, 0);
+	e::arena *a = pool.acquire();
+	e::arena *b = pool.acquire();
+	ASSERT_EQ(0U, pool.hits());
+	ASSERT_EQ(2U, pool.misses());
+
+	unsigned char *ptr = NULL;
+	a->allocate(100, &ptr);
+	pool.release(a);
+	pool.release(b);
+	ASSERT_EQ(4096U, pool.retained_bytes());
+
+	e::arena *c = pool.acquire();
+	ASSERT_TRUE(c == b);
+	e::arena *d = pool.acquire();
+	ASSERT_TRUE(d == a);
+	ASSERT_EQ(2U, pool.hits());
+	ASSERT_EQ(2U, pool.misses());
+	ASSERT_EQ(0U, pool.retained_bytes());
+	pool.release(c);
+	pool.release(d);
+}
+
+TEST(ArenaPoolTest, OverflowToShared)
+{
+	e::arena_pool pool(1, 0);
+	e::arena *a = pool.acquire();
+	e::arena *b = pool.acquire();
+	pool.release(a);
+	pool.release(b);
+	ASSERT_TRUE(pool.acquire() == a);
+	ASSERT_TRUE(pool.acquire() == b);
+	ASSERT_EQ(2U, pool.hits());
+	pool.release(a);
+	pool.release(b);
+}
+
+class counting_source : public e::arena_chunk_source
+{
+public:
+	counting_source() : allocations(0), largest(0) {}
+	virtual ~counting_source() throw () {}
+
+public:
+	virtual unsigned char *allocate(size_t *sz)
+	{
+		++allocations;
+		largest = *sz > largest ? *sz : largest;
+		return static_cast<unsigned char *>(malloc(*sz));
+	}
+	virtual void deallocate(unsigned char *ptr, size_t) { free(ptr); }
+
+public:
+	size_t allocations;
+	size_t largest;
+};
+
+TEST(ArenaPoolTest, ConstructionParameters)
+{
+	counting_source source;
+	e::arena_pool pool(2, 0, 16384, 65536, &source, 10000);
+
+	// the first chunk is reserved when the pool creates the arena
+	e::arena *a = pool.acquire();
+	ASSERT_EQ(1U, source.allocations);
+	ASSERT_EQ(10000U, source.largest);
+	unsigned char *ptr = NULL;
+	a->allocate(8000, &ptr);
+	ASSERT_EQ(1U, source.allocations);
+	pool.release(a);
+	ASSERT_TRUE(pool.acquire() == a);
+	ASSERT_EQ(1U, source.allocations);
+	pool.release(a);
+}
+
+struct handoff
+{
+	e::arena_pool *pool;
+	e::arena *arena;
+};
+
+void *
+release_elsewhere(void *_h)
+{
+	handoff *h = static_cast<handoff *>(_h);
+	h->pool->release(h->arena);
+	return NULL;
+}
+
+TEST(ArenaPoolTest, CrossThreadRelease)
+{
+	e::arena_pool pool(4, 0);
+	handoff h;
+	h.pool = &pool;
+	h.arena = pool.acquire();
+	pthread_t t;
+	ASSERT_EQ(0, pthread_create(&t, NULL, release_elsewhere, &h));
+	ASSERT_EQ(0, pthread_join(t, NULL));
+	// the releasing thread exited, so its cache moved to the shared list
+	ASSERT_TRUE(pool.acquire() == h.arena);
+	ASSERT_EQ(1U, pool.hits());
+	pool.release(h.arena);
+}
+
+} // namespace
@@ -27,12 +27,17 @@
 
 // C
 #include <stdint.h>
+#include <string.h>
 
 // C++
+#include <list>
 #include <memory>
+#include <string>
+#include <vector>
 
 // e
 #include "th.h"
+#include "e/arena.h"
 #include "e/buffer.h"
 
 #define ASSERT_MEMCMP(X, Y, S) ASSERT_EQ(0, memcmp(X, Y, S))
@@ -56,6 +61,22 @@ TEST(BufferTest, CtorAndDtor)
 	ASSERT_EQ(3U, c->capacity());
 }
 
+TEST(BufferTest, ArenaBacked)
+{
+	e::arena a(256, 4096);
+	e::buffer *x = e::buffer::create(&a, 8);
+	e::buffer *y = e::buffer::create(&a, "xyz", 3);
+	ASSERT_EQ(0U, x->size());
+	ASSERT_EQ(8U, x->capacity());
+	ASSERT_TRUE(y->cmp("xyz", 3));
+	x->pack() << uint64_t(0xdeadbeefcafebabeULL);
+	ASSERT_MEMCMP(x->data(), "\xde\xad\xbe\xef\xca\xfe\xba\xbe", 8);
+	e::arena::stats s;
+	a.statistics(&s);
+	ASSERT_EQ(1U, s.chunks);
+	ASSERT_EQ(0U, s.takeovers);
+}
+
 TEST(BufferTest, PackBuffer)
 {
 	uint64_t a = 0xdeadbeefcafebabe;
@@ -183,4 +204,206 @@ TEST(BufferTest, VectorUnpackFail)
 	ASSERT_EQ(0xbabe, vector_good[3]);
 }
 
+TEST(BufferTest, GrowablePack)
+{
+	e::buffer *buf = NULL;
+	e::packer p(&buf, 0);
+
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		p = p << i << e::slice("xyzzy", 5);
+	}
+
+	ASSERT_TRUE(buf != NULL);
+	ASSERT_EQ(1000U * 10U, buf->size());
+	ASSERT_LE(buf->size(), buf->capacity());
+	e::unpacker up = buf->unpack();
+
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		uint32_t x;
+		e::slice s;
+		up = up >> x >> s;
+		ASSERT_EQ(i, x);
+		ASSERT_TRUE(s == e::slice("xyzzy", 5));
+	}
+
+	delete buf;
+}
+
+TEST(BufferTest, GrowablePackAt)
+{
+	e::buffer *buf = e::buffer::create("\xde\xad", 2);
+	e::packer p(&buf, 4);
+	p = p << uint64_t(0xcafebabeULL);
+	ASSERT_TRUE(buf->cmp("\xde\xad\x00\x00"
+	                     "\x00\x00\x00\x00\xca\xfe\xba\xbe", 12));
+	delete buf;
+}
+
+TEST(BufferTest, FixedPack)
+{
+	std::auto_ptr<e::buffer> buf(e::buffer::create(16));
+	buf->pack() << e::pack_fixed(uint64_t(0xdeadbeefcafebabeULL), uint32_t(0x01020304UL), int8_t(-1));
+	ASSERT_EQ(13U, (e::fixed_pack<uint64_t, uint32_t, int8_t>::size));
+	ASSERT_TRUE(buf->cmp("\xde\xad\xbe\xef\xca\xfe\xba\xbe"
+	                     "\x01\x02\x03\x04" "\xff", 13));
+}
+
+TEST(BufferTest, FixedUnpack)
+{
+	std::auto_ptr<e::buffer> buf(e::buffer::create("\xde\xad\xbe\xef\xca\xfe\xba\xbe"
+	                                               "\x01\x02\x03\x04" "\xff" "\x42", 14));
+	uint64_t a = 0;
+	uint32_t b = 0;
+	int8_t c = 0;
+	uint8_t d = 0;
+	e::unpacker up = buf->unpack() >> e::unpack_fixed(a, b, c) >> d;
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(0xdeadbeefcafebabeULL, a);
+	ASSERT_EQ(0x01020304UL, b);
+	ASSERT_EQ(-1, c);
+	ASSERT_EQ(0x42, d);
+	ASSERT_EQ(0U, up.remain());
+	up = buf->unpack().advance(2) >> e::unpack_fixed(a, b, c);
+	ASSERT_TRUE(up.error());
+}
+
+TEST(BufferTest, FixedRoundTrip)
+{
+	std::auto_ptr<e::buffer> buf(e::buffer::create(64));
+	buf->pack() << e::pack_fixed(int8_t(1), int16_t(2), int32_t(3), int64_t(4),
+	                             uint8_t(5), uint16_t(6), uint32_t(7), double(8.5));
+	ASSERT_EQ(30U, buf->size());
+	int8_t a = 0; int16_t b = 0; int32_t c = 0; int64_t d = 0;
+	uint8_t e = 0; uint16_t f = 0; uint32_t g = 0; double h = 0;
+	e::unpacker up = buf->unpack() >> e::unpack_fixed(a, b, c, d, e, f, g, h);
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(1, a);
+	ASSERT_EQ(2, b);
+	ASSERT_EQ(3, c);
+	ASSERT_EQ(4, d);
+	ASSERT_EQ(5U, e);
+	ASSERT_EQ(6U, f);
+	ASSERT_EQ(7U, g);
+	const double expected = 8.5;
+	ASSERT_MEMCMP(&expected, &h, sizeof(double));
+}
+
+TEST(BufferTest, BulkVectorRoundTrip)
+{
+	// cover every tail length of the SIMD kernels and more than one block
+	for (size_t n = 0; n < 1100; n += (n < 40 ? 1 : 97))
+	{
+		std::vector<uint32_t> v32;
+		std::vector<uint64_t> v64;
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			v32.push_back(0x01020304UL * (i + 1));
+			v64.push_back(0x0102030405060708ULL * (i + 1));
+		}
+
+		std::auto_ptr<e::buffer> buf(e::buffer::create(16 + n * 12));
+		buf->pack() << v32 << v64;
+		ASSERT_EQ(size_t(2 * e::varint_length(n) + n * 12), buf->size());
+
+		if (n > 0)
+		{
+			uint32_t first;
+			e::unpacker up = buf->unpack().advance(e::varint_length(n)) >> first;
+			ASSERT_EQ(v32[0], first);
+		}
+
+		std::vector<uint32_t> r32;
+		std::vector<uint64_t> r64;
+		e::unpacker up = buf->unpack() >> r32 >> r64;
+		ASSERT_FALSE(up.error());
+		ASSERT_EQ(0U, up.remain());
+		ASSERT_TRUE(v32 == r32);
+		ASSERT_TRUE(v64 == r64);
+	}
+}
+
+TEST(BufferTest, BulkVectorUnpackShort)
+{
+	std::auto_ptr<e::buffer> buf(e::buffer::create("\x03"
+	                                               "\xde\xad\xbe\xef"
+	                                               "\xca\xfe\xba\xbe", 9));
+	std::vector<uint32_t> v;
+	ASSERT_TRUE((buf->unpack() >> v).error());
+	std::auto_ptr<e::buffer> huge(e::buffer::create("\xff\xff\xff\xff\xff\xff\xff\xff\x7f", 9));
+	ASSERT_TRUE((huge->unpack() >> v).error());
+}
+
+TEST(BufferTest, StringPackOverwrite)
+{
+	std::string s(16, 'x');
+	e::packer(&s, 10) << uint32_t(0xdeadbeefUL);
+	ASSERT_EQ(16U, s.size());
+	ASSERT_TRUE(s == std::string("xxxxxxxxxx\xde\xad\xbe\xefxx", 16));
+	e::packer(&s, 14) << uint32_t(0xcafebabeUL);
+	ASSERT_EQ(18U, s.size());
+	ASSERT_TRUE(s == std::string("xxxxxxxxxx\xde\xad\xbe\xef\xca\xfe\xba\xbe", 18));
+	e::packer(&s, 20) << uint8_t(1);
+	ASSERT_TRUE(s == std::string("xxxxxxxxxx\xde\xad\xbe\xef\xca\xfe\xba\xbe\x00\x00\x01", 21));
+}
+
+TEST(BufferTest, VarintContainers)
+{
+	std::vector<uint64_t> ids;
+	std::list<int32_t> deltas;
+
+	for (uint64_t i = 0; i < 1000; ++i)
+	{
+		ids.push_back(1000000000ULL + i * 3);
+		deltas.push_back(i % 2 ? -int32_t(i) : int32_t(i));
+	}
+
+	std::string s;
+	e::packer(&s) << e::pack_delta_varints(ids) << e::pack_zigzags(deltas) << e::pack_varints(ids);
+	ASSERT_EQ(e::pack_size(e::pack_delta_varints(ids)) +
+	          e::pack_size(e::pack_zigzags(deltas)) +
+	          e::pack_size(e::pack_varints(ids)), s.size());
+	// 2 byte count, 5 byte first element, 1 byte for each delta of 3
+	ASSERT_EQ(2U + 5U + 999U, e::pack_size(e::pack_delta_varints(ids)));
+
+	std::vector<uint64_t> ids2;
+	std::list<int32_t> deltas2;
+	std::vector<uint64_t> ids3;
+	e::unpacker up = e::unpacker(s) >> e::unpack_delta_varints(ids2)
+	                                >> e::unpack_zigzags(deltas2)
+	                                >> e::unpack_varints(ids3);
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(0U, up.remain());
+	ASSERT_TRUE(ids == ids2);
+	ASSERT_TRUE(deltas == deltas2);
+	ASSERT_TRUE(ids == ids3);
+}
+
+TEST(BufferTest, VarintContainersUnsortedDelta)
+{
+	std::vector<uint32_t> v;
+	v.push_back(5);
+	v.push_back(1);
+	v.push_back(0xffffffffUL);
+	v.push_back(0);
+	std::string s;
+	e::packer(&s) << e::pack_delta_varints(v);
+	std::vector<uint32_t> r;
+	ASSERT_FALSE((e::unpacker(s) >> e::unpack_delta_varints(r)).error());
+	ASSERT_TRUE(v == r);
+}
+
+TEST(BufferTest, VarintContainersOutOfRange)
+{
+	std::vector<uint64_t> big(1, 1ULL << 40);
+	std::string s;
+	e::packer(&s) << e::pack_varints(big);
+	std::vector<uint32_t> small;
+	ASSERT_TRUE((e::unpacker(s) >> e::unpack_varints(small)).error());
+	std::vector<uint64_t> truncated;
+	ASSERT_TRUE((e::unpacker(s.data(), s.size() - 1) >> e::unpack_varints(truncated)).error());
+}
+
 } // namespace
@@ -0,0 +1,259 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <string.h>
+#include <unistd.h>
+
+// STL
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// e
+#include "th.h"
+#include "e/buffer_chain.h"
+
+namespace
+{
+
+std::string
+flatten(const e::buffer_chain &chain)
+{
+	std::string s;
+
+	for (size_t i = 0; i < chain.segment_count(); ++i)
+	{
+		s += chain.segment(i).str();
+	}
+
+	return s;
+}
+
+TEST(BufferChainTest, PackCopiesSmallValues)
+{
+	e::buffer_chain chain;
+	chain.pack() << uint32_t(0xdeadbeefUL) << e::slice("abc", 3);
+	ASSERT_EQ(8U, chain.size());
+	ASSERT_EQ(1U, chain.segment_count());
+	ASSERT_TRUE(flatten(chain) == std::string("\xde\xad\xbe\xef\x03" "abc", 8));
+}
+
+TEST(BufferChainTest, PackReferencesLargeSlices)
+{
+	std::string payload(1000, 'x');
+	e::buffer_chain chain;
+	chain.pack() << uint16_t(7) << e::slice(payload) << uint8_t(9);
+	ASSERT_EQ(2U + 2U + 1000U + 1U, chain.size());
+	ASSERT_EQ(3U, chain.segment_count());
+	ASSERT_EQ(reinterpret_cast<const uint8_t *>(payload.data()), chain.segment(1).data());
+	ASSERT_EQ(1000U, chain.segment(1).size());
+}
+
+TEST(BufferChainTest, BackPatch)
+{
+	std::string payload(600, 'y');
+	e::buffer_chain chain(100);
+	e::packer header = chain.pack();
+	e::packer body = header << uint32_t(0);
+	body = body << e::slice(payload);
+	header << uint32_t(chain.size());
+	e::unpacker up(chain.segment(0));
+	uint32_t sz;
+	up = up >> sz;
+	ASSERT_EQ(chain.size(), sz);
+}
+
+TEST(BufferChainTest, AppendBuffersAndSharedSlices)
+{
+	e::shared_buffer::ref sb = e::shared_buffer::create("0123456789", 10);
+	e::buffer_chain chain;
+	chain.copy(e::slice("ab", 2));
+	chain.append(e::buffer::create("cd", 2));
+	chain.append(sb->slice(3, 4));
+	chain.reference(e::slice("ef", 2));
+	ASSERT_EQ(4U, chain.segment_count());
+	ASSERT_TRUE(flatten(chain) == "abcd3456ef");
+	std::auto_ptr<e::buffer> flat(chain.coalesce());
+	ASSERT_TRUE(flat->cmp("abcd3456ef", 10));
+}
+
+TEST(BufferChainTest, IovecsAndConsume)
+{
+	e::buffer_chain chain;
+	chain.reference(e::slice("hello ", 6));
+	chain.reference(e::slice("world", 5));
+	struct iovec iov[4];
+	ASSERT_EQ(2U, chain.iovecs(iov, 4));
+	ASSERT_EQ(6U, iov[0].iov_len);
+	ASSERT_EQ(1U, chain.iovecs(iov, 1));
+	chain.consume(8);
+	ASSERT_EQ(3U, chain.size());
+	ASSERT_TRUE(flatten(chain) == "rld");
+	chain.consume(3);
+	ASSERT_TRUE(chain.empty());
+	ASSERT_EQ(0U, chain.segment_count());
+}
+
+TEST(BufferChainTest, Writev)
+{
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	std::string payload(600, 'b');
+	e::buffer_chain chain;
+	chain.pack() << uint8_t('a') << e::slice(payload) << uint8_t('c');
+	const size_t sz = chain.size();
+	ASSERT_EQ(ssize_t(sz), chain.writev(fds[1]));
+	ASSERT_TRUE(chain.empty());
+	char buf[1024];
+	ASSERT_EQ(ssize_t(sz), read(fds[0], buf, sizeof(buf)));
+	ASSERT_EQ('a', buf[0]);
+	ASSERT_EQ('c', buf[sz - 1]);
+	close(fds[0]);
+	close(fds[1]);
+}
+
+TEST(BufferChainTest, UnpackAcrossSegments)
+{
+	std::vector<e::slice> segs;
+	segs.push_back(e::slice("\x00\x00", 2));
+	segs.push_back(e::slice("", 0));
+	segs.push_back(e::slice("\x01\x02\x05he", 5));
+	segs.push_back(e::slice("l", 1));
+	segs.push_back(e::slice("lo\xff", 3));
+	e::chain_unpacker up(segs);
+	ASSERT_EQ(11U, up.remain());
+	uint32_t x;
+	e::slice s;
+	uint8_t y;
+	up >> x >> s >> y;
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(0x0102U, x);
+	ASSERT_TRUE(s == e::slice("hello", 5));
+	ASSERT_EQ(0xff, y);
+	ASSERT_EQ(0U, up.remain());
+	up >> y;
+	ASSERT_TRUE(up.error());
+}
+
+TEST(BufferChainTest, UnpackAcrossManySegments)
+{
+	// a 2000-byte slice split one byte per segment, then a trailing value
+	std::string packed;
+	std::string payload(2000, 'q');
+	e::packer(&packed) << e::slice(payload) << uint8_t(9);
+	std::vector<e::slice> segs;
+
+	for (size_t i = 0; i < packed.size(); ++i)
+	{
+		segs.push_back(e::slice(packed.data() + i, 1));
+	}
+
+	e::chain_unpacker up(segs);
+	e::slice p;
+	uint8_t y;
+	up >> p >> y;
+	ASSERT_FALSE(up.error());
+	ASSERT_TRUE(p == e::slice(payload));
+	ASSERT_EQ(9, y);
+	ASSERT_EQ(0U, up.remain());
+}
+
+TEST(BufferChainTest, UnpackVectorsAcrossSegments)
+{
+	std::vector<uint64_t> ints;
+	std::vector<e::slice> strs;
+
+	for (size_t i = 0; i < 300; ++i)
+	{
+		ints.push_back(i * 0x0101010101ULL);
+		strs.push_back(e::slice("abcdefgh", i % 9));
+	}
+
+	std::string packed;
+	e::packer(&packed) << ints << strs << uint8_t(9);
+	std::vector<e::slice> segs;
+
+	for (size_t i = 0; i < packed.size(); i += 3)
+	{
+		segs.push_back(e::slice(packed.data() + i, std::min(size_t(3), packed.size() - i)));
+	}
+
+	e::chain_unpacker up(segs);
+	std::vector<uint64_t> ri;
+	std::vector<e::slice> rs;
+	uint8_t y;
+	up >> ri >> rs >> y;
+	ASSERT_FALSE(up.error());
+	ASSERT_TRUE(ri == ints);
+	ASSERT_TRUE(rs == strs);
+	ASSERT_EQ(9, y);
+	ASSERT_EQ(0U, up.remain());
+}
+
+TEST(BufferChainTest, UnpackPrefixOverrunsChain)
+{
+	// slice and vector prefixes claiming more bytes than the chain holds
+	std::vector<e::slice> segs;
+	segs.push_back(e::slice("\x80\x80", 2));
+	segs.push_back(e::slice("\x80\x01xyz", 5));
+	e::chain_unpacker up(segs);
+	e::slice s;
+	up >> s;
+	ASSERT_TRUE(up.error());
+	ASSERT_EQ(7U, up.remain());
+
+	e::chain_unpacker vup(segs);
+	std::vector<uint32_t> v;
+	vup >> v;
+	ASSERT_TRUE(vup.error());
+	ASSERT_EQ(7U, vup.remain());
+
+	segs.push_back(e::slice("\xff\xff\xff\xff\xff\xff\xff", 7));
+	e::chain_unpacker bad(std::vector<e::slice>(1, segs.back()));
+	bad >> s;
+	ASSERT_TRUE(bad.error());
+}
+
+TEST(BufferChainTest, UnpackChain)
+{
+	std::string payload(700, 'z');
+	e::buffer_chain chain;
+	chain.pack() << uint64_t(42) << e::slice(payload) << e::slice("tail", 4);
+	e::chain_unpacker up(chain);
+	uint64_t x;
+	e::slice p;
+	e::slice t;
+	up >> x >> p >> t;
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(42U, x);
+	ASSERT_TRUE(p == e::slice(payload));
+	ASSERT_TRUE(t == e::slice("tail", 4));
+}
+
+} // namespace
@@ -30,8 +30,13 @@
 // C
 #include <string.h>
 
+// STL
+#include <algorithm>
+#include <vector>
+
 // e
 #include "th.h"
+#include "bswap.h"
 #include "e/endian.h"
 
 #define ASSERT_MEMCMP(X, Y, S) ASSERT_EQ(0, memcmp(X, Y, S))
@@ -148,4 +153,109 @@ TEST(EndianTest, Unpack)
 	ASSERT_EQ(9006104071832581.0, d);
 }
 
+TEST(EndianTest, Bulk)
+{
+	// every length up to a few AVX2 strides, so each kernel's tail runs
+	for (size_t n = 0; n < 40; ++n)
+	{
+		std::vector<uint32_t> u32(n + 1);
+		std::vector<uint64_t> u64(n + 1);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			u32[i] = 0x01020304UL * (i + 1);
+			u64[i] = 0x0102030405060708ULL * (i + 1);
+		}
+
+		std::vector<uint8_t> expected(n * 8 + 1);
+		std::vector<uint8_t> actual(n * 8 + 1);
+		std::vector<uint32_t> back32(n + 1);
+		std::vector<uint64_t> back64(n + 1);
+
+#define BULK_CASE(W, END) \
+		for (size_t i = 0; i < n; ++i) \
+		{ \
+			e::pack ## W ## END(u ## W[i], &expected[i * W / 8]); \
+		} \
+		ASSERT_EQ(&actual[n * W / 8], e::pack ## W ## END ## _n(&u ## W[0], n, &actual[0])); \
+		ASSERT_MEMCMP(&expected[0], &actual[0], n * W / 8); \
+		ASSERT_EQ(&actual[n * W / 8], e::unpack ## W ## END ## _n(&actual[0], n, &back ## W[0])); \
+		ASSERT_MEMCMP(&u ## W[0], &back ## W[0], n * W / 8);
+
+		BULK_CASE(32, be)
+		BULK_CASE(32, le)
+		BULK_CASE(64, be)
+		BULK_CASE(64, le)
+#undef BULK_CASE
+	}
+}
+
+TEST(EndianTest, BulkKernels)
+{
+	// the dispatched kernel hides the others, so run each one directly
+	typedef void (*kernel)(const uint8_t *src, size_t n, uint8_t *dst);
+	std::vector<kernel> k32(1, e::bswap32_scalar);
+	std::vector<kernel> k64(1, e::bswap64_scalar);
+#ifdef E_BSWAP_X86
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("ssse3"))
+	{
+		k32.push_back(e::bswap32_ssse3);
+		k64.push_back(e::bswap64_ssse3);
+	}
+
+	if (__builtin_cpu_supports("avx2"))
+	{
+		k32.push_back(e::bswap32_avx2);
+		k64.push_back(e::bswap64_avx2);
+	}
+#endif // E_BSWAP_X86
+
+	for (size_t n = 0; n < 40; ++n)
+	{
+		std::vector<uint8_t> src(n * 8 + 1);
+
+		for (size_t i = 0; i < src.size(); ++i)
+		{
+			src[i] = i * 7 + 1;
+		}
+
+		std::vector<uint8_t> expected(n * 8 + 1, 0xee);
+		std::vector<uint8_t> actual(n * 8 + 1, 0xee);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < 8; ++j)
+			{
+				expected[i * 8 + j] = src[i * 8 + 7 - j];
+			}
+		}
+
+		for (size_t i = 0; i < k64.size(); ++i)
+		{
+			std::fill(actual.begin(), actual.end(), 0xee);
+			k64[i](&src[0], n, &actual[0]);
+			ASSERT_MEMCMP(&expected[0], &actual[0], actual.size());
+		}
+
+		std::fill(expected.begin(), expected.end(), 0xee);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < 4; ++j)
+			{
+				expected[i * 4 + j] = src[i * 4 + 3 - j];
+			}
+		}
+
+		for (size_t i = 0; i < k32.size(); ++i)
+		{
+			std::fill(actual.begin(), actual.end(), 0xee);
+			k32[i](&src[0], n, &actual[0]);
+			ASSERT_MEMCMP(&expected[0], &actual[0], actual.size());
+		}
+	}
+}
+
 } // namespace
@@ -0,0 +1,166 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <stdlib.h>
+#include <unistd.h>
+
+// STL
+#include <string>
+
+// e
+#include "th.h"
+#include "e/fd_reader.h"
+
+namespace
+{
+
+int
+temp_file(const std::string &contents)
+{
+	char name[] = "/tmp/e-fd-reader-XXXXXX";
+	int fd = mkstemp(name);
+	unlink(name);
+
+	if (fd < 0 || write(fd, contents.data(), contents.size()) != ssize_t(contents.size()))
+	{
+		abort();
+	}
+
+	lseek(fd, 0, SEEK_SET);
+	return fd;
+}
+
+std::string
+records(uint32_t n)
+{
+	std::string s;
+	e::packer pa(&s);
+
+	for (uint32_t i = 0; i < n; ++i)
+	{
+		pa = pa << i << e::slice(std::string(i % 50, 'a' + i % 26));
+	}
+
+	return s;
+}
+
+TEST(FdReaderTest, SmallWindowGrowsAndRefills)
+{
+	int fd = temp_file(records(1000));
+
+	{
+		// initial window smaller than most records
+		e::fd_reader r(fd, 8, 1024);
+		uint32_t i = 0;
+
+		while (!r.done())
+		{
+			uint32_t x;
+			e::slice s;
+			r >> x >> s;
+			ASSERT_FALSE(r.error());
+			ASSERT_EQ(i, x);
+			ASSERT_TRUE(s == e::slice(std::string(i % 50, 'a' + i % 26)));
+			++i;
+		}
+
+		ASSERT_EQ(1000U, i);
+		ASSERT_FALSE(r.error());
+		uint8_t extra;
+		r >> extra;
+		ASSERT_TRUE(r.error());
+		ASSERT_EQ(0, r.io_error());
+	}
+
+	close(fd);
+}
+
+TEST(FdReaderTest, ValueLargerThanMaxWindow)
+{
+	std::string s;
+	e::packer(&s) << e::slice(std::string(100, 'x'));
+	int fd = temp_file(s);
+	e::fd_reader r(fd, 16, 64);
+	e::slice x;
+	r >> x;
+	ASSERT_TRUE(r.error());
+	close(fd);
+}
+
+TEST(FdReaderTest, Pipe)
+{
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	ASSERT_EQ(4, write(fds[1], "\x00\x00\x00\x07", 4));
+	ASSERT_EQ(2, write(fds[1], "\x00\x00", 2));
+	e::fd_reader r(fds[0]);
+	uint32_t x;
+	r >> x;
+	ASSERT_EQ(7U, x);
+	ASSERT_EQ(2, write(fds[1], "\x00\x09", 2));
+	close(fds[1]);
+	r >> x;
+	ASSERT_EQ(9U, x);
+	ASSERT_TRUE(r.done());
+	close(fds[0]);
+}
+
+TEST(MappedReaderTest, Decode)
+{
+	int fd = temp_file(records(20000));
+	e::mapped_reader m(fd);
+	ASSERT_EQ(0, m.error());
+	e::unpacker up = m.unpack();
+
+	for (uint32_t i = 0; i < 20000; ++i)
+	{
+		uint32_t x;
+		e::slice s;
+		up = up >> x >> s;
+		ASSERT_EQ(i, x);
+		ASSERT_EQ(i % 50, s.size());
+		m.consumed(up);
+	}
+
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(0U, up.remain());
+	close(fd);
+}
+
+TEST(MappedReaderTest, EmptyFile)
+{
+	int fd = temp_file("");
+	e::mapped_reader m(fd);
+	ASSERT_EQ(0, m.error());
+	ASSERT_EQ(0U, m.size());
+	ASSERT_EQ(0U, m.unpack().remain());
+	close(fd);
+}
+
+} // namespace
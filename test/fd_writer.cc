@@ -0,0 +1,167 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// STL
+#include <string>
+
+// e
+#include "th.h"
+#include "e/fd_writer.h"
+#include "e/static_packer.h"
+
+namespace
+{
+
+class tmpfile
+{
+public:
+	tmpfile() : fd(-1) { char name[] = "/tmp/e-fd-writer-XXXXXX"; fd = mkstemp(name); unlink(name); }
+	~tmpfile() throw () { if (fd >= 0) close(fd); }
+
+public:
+	std::string contents()
+	{
+		std::string s;
+		char buf[4096];
+		ssize_t ret;
+		off_t off = 0;
+
+		while ((ret = pread(fd, buf, sizeof(buf), off)) > 0)
+		{
+			s.append(buf, ret);
+			off += ret;
+		}
+
+		return s;
+	}
+
+public:
+	int fd;
+
+private:
+	tmpfile(const tmpfile &);
+	tmpfile &operator = (const tmpfile &);
+};
+
+void
+check_stream(unsigned options)
+{
+	tmpfile f;
+	ASSERT_LE(0, f.fd);
+	std::string expected;
+
+	{
+		e::fd_writer w(f.fd, 4096, options);
+		e::packer header = w.pack();
+		e::packer pa = header << uint64_t(0);
+		e::packer(&expected) << uint64_t(0);
+
+		for (uint32_t i = 0; i < 10000; ++i)
+		{
+			pa = pa << i << e::slice("payload", 7);
+			e::packer(&expected, expected.size()) << i << e::slice("payload", 7);
+		}
+
+		// back-patch bytes that were written out long ago
+		header << uint64_t(w.size());
+		e::packer(&expected, 0) << uint64_t(expected.size());
+		ASSERT_EQ(expected.size(), w.size());
+		ASSERT_TRUE(w.flush());
+		ASSERT_EQ(0, w.error());
+	}
+
+	ASSERT_TRUE(f.contents() == expected);
+}
+
+TEST(FdWriterTest, Stream)
+{
+	check_stream(0);
+}
+
+TEST(FdWriterTest, StreamSync)
+{
+	check_stream(e::fd_writer::SYNC);
+}
+
+TEST(FdWriterTest, StreamDirect)
+{
+	check_stream(e::fd_writer::DIRECT);
+}
+
+TEST(FdWriterTest, LargeWriteAndGap)
+{
+	tmpfile f;
+	std::string big(3 * 1048576 + 7, 'x');
+	e::fd_writer w(f.fd);
+	w.pack() << e::pack_memmove(big.data(), big.size());
+	w.pack() << uint8_t(1);
+	ASSERT_TRUE(w.sync());
+	ASSERT_EQ(big.size() + 1, w.size());
+	std::string c = f.contents();
+	ASSERT_EQ(big.size() + 1, c.size());
+	ASSERT_TRUE(c.compare(0, big.size(), big) == 0);
+	ASSERT_EQ('\x01', c[big.size()]);
+}
+
+TEST(FdWriterTest, StaticPacker)
+{
+	tmpfile f;
+	e::fd_writer w(f.fd, 4096, 0);
+	e::static_packer<e::fd_writer> pa(&w);
+	pa = pa << uint32_t(0xdeadbeefUL) << e::slice("abc", 3);
+	ASSERT_TRUE(w.flush());
+	ASSERT_TRUE(f.contents() == std::string("\xde\xad\xbe\xef\x03" "abc", 8));
+}
+
+TEST(FdWriterTest, PatchPipeFails)
+{
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+
+	{
+		e::fd_writer w(fds[1], 4096, 0);
+		e::packer header = w.pack();
+		e::packer pa = header << uint32_t(0);
+		std::string fill(8192, 'z');
+		pa << e::pack_memmove(fill.data(), fill.size());
+		ASSERT_EQ(0, w.error());
+		header << uint32_t(1);
+		ASSERT_EQ(ESPIPE, w.error());
+		ASSERT_FALSE(w.flush());
+	}
+
+	close(fds[0]);
+	close(fds[1]);
+}
+
+} // namespace
@@ -0,0 +1,165 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <string.h>
+
+// STL
+#include <string>
+#include <vector>
+
+// e
+#include "th.h"
+#include "e/group_varint.h"
+
+namespace
+{
+
+// a mix of every encoded length, in runs that start at every offset within
+// a group
+std::vector<uint32_t>
+sample(size_t n)
+{
+	std::vector<uint32_t> v;
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		const unsigned shift = (i * 7 + i / 5) % 32;
+		v.push_back((uint32_t(0x9e3779b9) * (i + 1)) >> shift);
+	}
+
+	return v;
+}
+
+TEST(GroupVarintTest, Layout)
+{
+	const uint32_t v[] = {1, 0x100, 0x10000, 0x1000000, 0xff};
+	uint8_t buf[16];
+	ASSERT_EQ(13U, e::group_varint_length(v, 5));
+	ASSERT_EQ(buf + 13, e::group_varint_encode(buf, v, 5));
+	ASSERT_EQ(0, memcmp(buf, "\xe4\x01\x00\x01\x00\x00\x01\x00\x00\x00\x01\x00\xff", 13));
+	ASSERT_EQ(13U, e::stream_vbyte_length(v, 5));
+	ASSERT_EQ(buf + 13, e::stream_vbyte_encode(buf, v, 5));
+	ASSERT_EQ(0, memcmp(buf, "\xe4\x00\x01\x00\x01\x00\x00\x01\x00\x00\x00\x01\xff", 13));
+}
+
+TEST(GroupVarintTest, RoundTrip)
+{
+	for (size_t n = 0; n < 70; ++n)
+	{
+		const std::vector<uint32_t> v = sample(n);
+		const uint32_t *in = n ? &v[0] : NULL;
+		const size_t sz = e::group_varint_length(in, n);
+		// trailing slack so some groups take the 16-byte load and some not
+		std::vector<uint8_t> group(sz + 1);
+		std::vector<uint8_t> stream(sz + 1);
+		ASSERT_EQ(&group[0] + sz, e::group_varint_encode(&group[0], in, n));
+		ASSERT_EQ(&stream[0] + sz, e::stream_vbyte_encode(&stream[0], in, n));
+		std::vector<uint32_t> out(n + 1);
+		ASSERT_EQ(&group[0] + sz, e::group_varint_decode(&group[0], &group[0] + sz, &out[0], n));
+		ASSERT_TRUE(std::vector<uint32_t>(out.begin(), out.begin() + n) == v);
+		out.assign(n + 1, 0);
+		ASSERT_EQ(&stream[0] + sz, e::stream_vbyte_decode(&stream[0], &stream[0] + sz, &out[0], n));
+		ASSERT_TRUE(std::vector<uint32_t>(out.begin(), out.begin() + n) == v);
+	}
+}
+
+TEST(GroupVarintTest, Truncated)
+{
+	const std::vector<uint32_t> v = sample(41);
+	const size_t sz = e::group_varint_length(&v[0], v.size());
+	std::vector<uint8_t> group(sz);
+	std::vector<uint8_t> stream(sz);
+	e::group_varint_encode(&group[0], &v[0], v.size());
+	e::stream_vbyte_encode(&stream[0], &v[0], v.size());
+	std::vector<uint32_t> out(v.size());
+
+	for (size_t len = 0; len < sz; ++len)
+	{
+		ASSERT_TRUE(e::group_varint_decode(&group[0], &group[0] + len, &out[0], v.size()) == NULL);
+		ASSERT_TRUE(e::stream_vbyte_decode(&stream[0], &stream[0] + len, &out[0], v.size()) == NULL);
+	}
+}
+
+TEST(GroupVarintTest, PackMatchesEncode)
+{
+	// packing works a chunk at a time; check sizes around the boundaries
+	const size_t sizes[] = {0, 1, 5, 511, 512, 513, 1023, 1537};
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+	{
+		const size_t n = sizes[i];
+		const std::vector<uint32_t> v = sample(n);
+		const uint32_t *in = n ? &v[0] : NULL;
+		const size_t sz = e::group_varint_length(in, n);
+		std::vector<uint8_t> flat(sz + 1);
+		std::string prefix;
+		e::packer(&prefix) << e::pack_varint(n);
+
+		std::string group;
+		e::packer(&group) << e::pack_group_varints(v);
+		ASSERT_EQ(prefix.size() + sz, group.size());
+		e::group_varint_encode(&flat[0], in, n);
+		ASSERT_TRUE(group == prefix + std::string(reinterpret_cast<const char *>(&flat[0]), sz));
+
+		std::string stream;
+		e::packer(&stream) << e::pack_stream_vbytes(v);
+		ASSERT_EQ(prefix.size() + sz, stream.size());
+		e::stream_vbyte_encode(&flat[0], in, n);
+		ASSERT_TRUE(stream == prefix + std::string(reinterpret_cast<const char *>(&flat[0]), sz));
+	}
+}
+
+TEST(GroupVarintTest, PackUnpack)
+{
+	const std::vector<uint32_t> v = sample(1000);
+	std::vector<uint32_t> group;
+	std::vector<uint32_t> stream;
+	const size_t sz = pack_size(e::pack_group_varints(v));
+	ASSERT_EQ(sz, pack_size(e::pack_stream_vbytes(v)));
+	std::string s;
+	e::packer(&s) << e::pack_group_varints(v) << e::pack_stream_vbytes(v) << uint8_t(7);
+	ASSERT_EQ(2 * sz + 1, s.size());
+	uint8_t tail = 0;
+	e::unpacker up = e::unpacker(s) >> e::unpack_group_varints(group)
+	                                 >> e::unpack_stream_vbytes(stream) >> tail;
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(0U, up.remain());
+	ASSERT_TRUE(group == v);
+	ASSERT_TRUE(stream == v);
+	ASSERT_EQ(7, tail);
+
+	// a count that cannot fit, and data cut short
+	up = e::unpacker(s.data(), 2) >> e::unpack_group_varints(group);
+	ASSERT_TRUE(up.error());
+	up = e::unpacker(s.data() + sz, sz - 1) >> e::unpack_stream_vbytes(stream);
+	ASSERT_TRUE(up.error());
+	ASSERT_TRUE(stream.empty());
+}
+
+} // namespace
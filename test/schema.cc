@@ -0,0 +1,179 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// STL
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+// e
+#include "th.h"
+#include "e/schema.h"
+
+namespace
+{
+
+#define HEADER_FIELDS(F) \
+	F(uint32_t, magic) \
+	F(uint16_t, type) \
+	F(int64_t, offset)
+
+struct header
+{
+	E_SCHEMA(header, HEADER_FIELDS)
+};
+
+E_SCHEMA_SERIALIZATION(header, HEADER_FIELDS)
+
+#define MESSAGE_FIELDS(F) \
+	F(header, hdr) \
+	F(e::slice, payload) \
+	F(std::vector<uint64_t>, ids)
+
+struct message
+{
+	E_SCHEMA(message, MESSAGE_FIELDS)
+};
+
+E_SCHEMA_SERIALIZATION(message, MESSAGE_FIELDS)
+
+#define PAIR_FIELDS(F) \
+	F(header, first) \
+	F(header, second)
+
+struct header_pair
+{
+	E_SCHEMA(header_pair, PAIR_FIELDS)
+};
+
+E_SCHEMA_SERIALIZATION(header_pair, PAIR_FIELDS)
+
+typedef std::pair<header, uint32_t> tagged_header;
+
+#define BATCH_FIELDS(F) \
+	F(std::list<header>, headers) \
+	F(tagged_header, tagged)
+
+struct batch
+{
+	E_SCHEMA(batch, BATCH_FIELDS)
+};
+
+E_SCHEMA_SERIALIZATION(batch, BATCH_FIELDS)
+
+TEST(SchemaTest, FixedSize)
+{
+	ASSERT_TRUE(e::schema_traits<header>::fixed);
+	ASSERT_FALSE(e::schema_traits<message>::fixed);
+	ASSERT_TRUE(e::schema_traits<header_pair>::fixed);
+	uint8_t hbuf[e::fixed_schema_size<header>::value];
+	uint8_t pbuf[e::fixed_schema_size<header_pair>::value];
+	ASSERT_EQ(14U, sizeof(hbuf));
+	ASSERT_EQ(28U, sizeof(pbuf));
+	header h;
+	ASSERT_EQ(14U, pack_size(h));
+}
+
+TEST(SchemaTest, ValueInitialized)
+{
+	const message m;
+	ASSERT_EQ(0U, m.hdr.magic);
+	ASSERT_EQ(0U, m.hdr.type);
+	ASSERT_EQ(0, m.hdr.offset);
+	ASSERT_TRUE(m.payload.empty());
+	ASSERT_TRUE(m.ids.empty());
+}
+
+TEST(SchemaTest, PackMatchesHandWritten)
+{
+	header h;
+	h.magic = 0xdeadbeefUL;
+	h.type = 7;
+	h.offset = -2;
+	std::string generated;
+	std::string manual;
+	e::packer(&generated) << h;
+	e::packer(&manual) << h.magic << h.type << h.offset;
+	ASSERT_TRUE(generated == manual);
+}
+
+TEST(SchemaTest, RoundTrip)
+{
+	message m;
+	m.hdr.magic = 1;
+	m.hdr.type = 2;
+	m.hdr.offset = 3;
+	m.payload = e::slice("hello", 5);
+	m.ids.push_back(4);
+	m.ids.push_back(5);
+	std::string s;
+	e::packer(&s) << m;
+	ASSERT_EQ(s.size(), pack_size(m));
+	ASSERT_EQ(14U + 6U + 1U + 16U, pack_size(m));
+
+	message r;
+	e::unpacker up = e::unpacker(s) >> r;
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(0U, up.remain());
+	ASSERT_EQ(1U, r.hdr.magic);
+	ASSERT_EQ(2U, r.hdr.type);
+	ASSERT_EQ(3, r.hdr.offset);
+	ASSERT_TRUE(r.payload == e::slice("hello", 5));
+	ASSERT_TRUE(r.ids == m.ids);
+	ASSERT_TRUE((e::unpacker(s.data(), s.size() - 1) >> r).error());
+}
+
+TEST(SchemaTest, ListAndPairFields)
+{
+	header h;
+	h.magic = 1;
+	h.type = 2;
+	h.offset = 3;
+	batch b;
+	b.headers.push_back(h);
+	h.magic = 4;
+	b.headers.push_back(h);
+	b.tagged = std::make_pair(h, 5U);
+	std::string s;
+	e::packer(&s) << b;
+	ASSERT_EQ(1U + 2U * 14U + 14U + 4U, pack_size(b));
+	ASSERT_EQ(s.size(), pack_size(b));
+
+	batch r;
+	e::unpacker up = e::unpacker(s) >> r;
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(0U, up.remain());
+	ASSERT_EQ(2U, r.headers.size());
+	ASSERT_EQ(1U, r.headers.front().magic);
+	ASSERT_EQ(4U, r.headers.back().magic);
+	ASSERT_EQ(4U, r.tagged.first.magic);
+	ASSERT_EQ(5U, r.tagged.second);
+}
+
+} // namespace
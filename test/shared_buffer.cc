@@ -0,0 +1,150 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// STL
+#include <string>
+
+// e
+#include "th.h"
+#include "e/shared_buffer.h"
+
+namespace
+{
+
+TEST(SharedBufferTest, Create)
+{
+	e::shared_buffer::ref buf = e::shared_buffer::create("\xde\xad\xbe\xef", 4);
+	ASSERT_EQ(4U, buf->size());
+	ASSERT_TRUE(buf->as_slice() == e::slice("\xde\xad\xbe\xef", 4));
+	uint32_t x;
+	e::unpacker up = buf->unpack() >> x;
+	ASSERT_FALSE(up.error());
+	ASSERT_EQ(0xdeadbeefUL, x);
+}
+
+TEST(SharedBufferTest, AdoptDoesNotCopy)
+{
+	e::buffer *raw = e::buffer::create("\xca\xfe\xba\xbe", 4);
+	const uint8_t *data = raw->data();
+	e::shared_buffer::ref buf = e::shared_buffer::adopt(raw);
+	ASSERT_EQ(data, buf->data());
+	ASSERT_EQ(4U, buf->size());
+}
+
+TEST(SharedBufferTest, SlicesShareStorage)
+{
+	e::shared_buffer::ref buf = e::shared_buffer::create("0123456789", 10);
+	e::shared_slice all(buf);
+	e::shared_slice mid = buf->slice(2, 5);
+	e::shared_slice sub = mid.sub(1, 2);
+	ASSERT_EQ(buf->data(), all.data());
+	ASSERT_EQ(buf->data() + 2, mid.data());
+	ASSERT_TRUE(mid.as_slice() == e::slice("23456", 5));
+	ASSERT_TRUE(sub.as_slice() == e::slice("34", 2));
+	ASSERT_TRUE(sub.owner() == buf);
+}
+
+TEST(SharedBufferTest, SlicesClamp)
+{
+	e::shared_buffer::ref buf = e::shared_buffer::create("0123456789", 10);
+	ASSERT_EQ(3U, buf->slice(7, 100).size());
+	ASSERT_TRUE(buf->slice(20, 1).empty());
+	ASSERT_EQ(1U, buf->slice(4, 5).sub(4, 10).size());
+	ASSERT_TRUE(buf->slice(4, 5).sub(6, 1).empty());
+}
+
+TEST(SharedBufferTest, SliceOutlivesReference)
+{
+	e::shared_slice s;
+	ASSERT_TRUE(s.empty());
+
+	{
+		e::shared_buffer::ref buf = e::shared_buffer::create("xyzzy", 5);
+		s = buf->slice(1, 3);
+	}
+
+	ASSERT_TRUE(s.as_slice() == e::slice("yzz", 3));
+	e::shared_slice t(s);
+	s = e::shared_slice();
+	ASSERT_TRUE(t.as_slice() == e::slice("yzz", 3));
+}
+
+TEST(SharedBufferTest, UnpackShared)
+{
+	e::shared_slice a;
+	e::shared_slice b;
+	uint32_t x;
+
+	{
+		std::string msg;
+		e::packer(&msg) << e::slice("hello", 5) << uint32_t(7) << e::slice("world", 5);
+		e::shared_buffer::ref buf = e::shared_buffer::create(msg.data(), msg.size());
+		e::unpacker up = buf->unpack() >> e::unpack_shared(buf, a) >> x
+		                               >> e::unpack_shared(buf, b);
+		ASSERT_FALSE(up.error());
+		ASSERT_EQ(buf->data() + 1, a.data());
+	}
+
+	ASSERT_TRUE(a.as_slice() == e::slice("hello", 5));
+	ASSERT_EQ(7U, x);
+	ASSERT_TRUE(b.as_slice() == e::slice("world", 5));
+	ASSERT_TRUE(a.owner() == b.owner());
+}
+
+TEST(SharedBufferTest, UnpackSharedFromSubSlice)
+{
+	std::string msg;
+	e::packer(&msg) << uint8_t(0) << e::slice("abc", 3);
+	e::shared_buffer::ref buf = e::shared_buffer::create(msg.data(), msg.size());
+	e::shared_slice body = buf->slice(1, 4);
+	e::shared_slice out;
+	e::unpacker up = body.unpack() >> e::unpack_shared(body.owner(), out);
+	ASSERT_FALSE(up.error());
+	ASSERT_TRUE(out.as_slice() == e::slice("abc", 3));
+}
+
+TEST(SharedBufferTest, UnpackSharedWrongOwner)
+{
+	e::shared_buffer::ref buf = e::shared_buffer::create("\x03" "abc", 4);
+	e::shared_buffer::ref other = e::shared_buffer::create("\x03" "abc", 4);
+	e::shared_slice out;
+	e::unpacker up = buf->unpack() >> e::unpack_shared(other, out);
+	ASSERT_TRUE(up.error());
+	ASSERT_TRUE(out.empty());
+}
+
+TEST(SharedBufferTest, PackSharedSlice)
+{
+	e::shared_buffer::ref buf = e::shared_buffer::create("0123456789", 10);
+	std::string msg;
+	e::packer(&msg) << buf->slice(2, 3);
+	ASSERT_EQ(e::pack_size(buf->slice(2, 3)), msg.size());
+	ASSERT_TRUE(msg == std::string("\x03" "234", 4));
+}
+
+} // namespace
@@ -0,0 +1,134 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <string.h>
+
+// STL
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+// e
+#include "th.h"
+#include "e/slice.h"
+
+namespace
+{
+
+TEST(SliceTest, Compare)
+{
+	// the length-first order is kept as-is
+	ASSERT_TRUE(e::slice("b") < e::slice("aa"));
+	ASSERT_TRUE(e::slice("ab") < e::slice("ba"));
+	ASSERT_TRUE(e::slice("ab") == e::slice("ab"));
+}
+
+TEST(SliceTest, LexicographicCompare)
+{
+	ASSERT_EQ(0, e::slice().lexicographic_compare(e::slice()));
+	ASSERT_EQ(0, e::slice("abc").lexicographic_compare(e::slice("abc")));
+	ASSERT_TRUE(e::slice("aa").lexicographic_compare(e::slice("b")) < 0);
+	ASSERT_TRUE(e::slice("b").lexicographic_compare(e::slice("aa")) > 0);
+	ASSERT_TRUE(e::slice("ab").lexicographic_compare(e::slice("abc")) < 0);
+	ASSERT_TRUE(e::slice("abc").lexicographic_compare(e::slice("ab")) > 0);
+	ASSERT_TRUE(e::slice().lexicographic_compare(e::slice("a")) < 0);
+	// bytes compare as unsigned
+	ASSERT_TRUE(e::slice("\x7f", 1).lexicographic_compare(e::slice("\x80", 1)) < 0);
+
+	// agrees with std::string's ordering
+	const char *words[] = {"b", "aa", "", "ab", "a", "\xff", "abc", "ba", "a\0b"};
+	std::vector<std::string> strs;
+	std::vector<e::slice> slices;
+
+	for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i)
+	{
+		strs.push_back(words[i]);
+	}
+
+	strs.push_back(std::string("a\0b", 3));
+
+	for (size_t i = 0; i < strs.size(); ++i)
+	{
+		slices.push_back(e::slice(strs[i]));
+	}
+
+	std::vector<std::string> sorted(strs);
+	std::sort(sorted.begin(), sorted.end());
+	std::sort(slices.begin(), slices.end(), e::slice_lexicographic_less());
+
+	for (size_t i = 0; i < sorted.size(); ++i)
+	{
+		ASSERT_TRUE(slices[i].str() == sorted[i]);
+	}
+
+	std::map<e::slice, int, e::slice_lexicographic_less> m;
+	m[e::slice("b")] = 1;
+	m[e::slice("aa")] = 2;
+	ASSERT_TRUE(m.begin()->first.str() == "aa");
+}
+
+TEST(SliceTest, CommonPrefixLength)
+{
+	ASSERT_EQ(0U, e::slice().common_prefix_length(e::slice("abc")));
+	ASSERT_EQ(0U, e::slice("abc").common_prefix_length(e::slice("xbc")));
+	ASSERT_EQ(3U, e::slice("abc").common_prefix_length(e::slice("abc")));
+	ASSERT_EQ(2U, e::slice("ab").common_prefix_length(e::slice("abc")));
+
+	// a difference at every position, for lengths that end in each of the
+	// 16-byte, 8-byte and single-byte loops
+	for (size_t sz = 1; sz < 70; ++sz)
+	{
+		const std::string a(sz, 'q');
+
+		for (size_t i = 0; i < sz; ++i)
+		{
+			std::string b(a);
+			b[i] = 'r';
+			ASSERT_EQ(i, e::slice(a).common_prefix_length(e::slice(b)));
+			ASSERT_EQ(i, e::slice(b).common_prefix_length(e::slice(a)));
+		}
+
+		ASSERT_EQ(sz, e::slice(a).common_prefix_length(e::slice(a + "x")));
+	}
+}
+
+TEST(SliceTest, EqualsAndStartsWith)
+{
+	ASSERT_TRUE(e::slice().equals(e::slice()));
+	ASSERT_TRUE(e::slice("abc").equals(e::slice("abc")));
+	ASSERT_FALSE(e::slice("abc").equals(e::slice("abd")));
+	ASSERT_FALSE(e::slice("abc").equals(e::slice("ab")));
+	ASSERT_TRUE(e::slice("abc").starts_with(e::slice("ab")));
+	ASSERT_TRUE(e::slice("abc").starts_with(e::slice()));
+	ASSERT_FALSE(e::slice("ab").starts_with(e::slice("abc")));
+	ASSERT_FALSE(e::slice("abc").starts_with(e::slice("b")));
+}
+
+} // namespace
@@ -0,0 +1,155 @@
+// Copyright (c) 2026, Robert Escriva
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of this project nor the names of its contributors may
+//       be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <string.h>
+
+// STL
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+// e
+#include "th.h"
+#include "e/static_packer.h"
+
+namespace
+{
+
+TEST(StaticPackerTest, MatchesPacker)
+{
+	std::vector<uint16_t> v;
+	v.push_back(0xdead);
+	v.push_back(0xbeef);
+	std::pair<uint8_t, uint32_t> p(7, 0xcafebabeUL);
+	uint32_t arr[2] = {1, 2};
+
+	std::string expected;
+	e::packer(&expected) << int8_t(-1) << uint16_t(0x0102) << int32_t(-2)
+	                     << uint64_t(0x0102030405060708ULL) << double(1.5)
+	                     << e::pack_varint(300) << e::slice("xyz", 3)
+	                     << e::pack_memmove("ab", 2) << v << p
+	                     << e::pack_array<uint32_t>(arr, 2);
+
+	std::string actual;
+	e::string_sink sink(&actual);
+	e::static_packer<e::string_sink>(&sink) << int8_t(-1) << uint16_t(0x0102) << int32_t(-2)
+	                                        << uint64_t(0x0102030405060708ULL) << double(1.5)
+	                                        << e::pack_varint(300) << e::slice("xyz", 3)
+	                                        << e::pack_memmove("ab", 2) << v << p
+	                                        << e::pack_array<uint32_t>(arr, 2);
+	ASSERT_TRUE(expected == actual);
+}
+
+TEST(StaticPackerTest, BulkVectors)
+{
+	// longer than one 4KB run of either width
+	std::vector<uint32_t> v32;
+	std::vector<uint64_t> v64;
+
+	for (uint32_t i = 0; i < 1500; ++i)
+	{
+		v32.push_back(i * 0x01010101UL);
+		v64.push_back(i * 0x0101010101010101ULL);
+	}
+
+	std::string expected;
+	e::packer(&expected) << v32 << v64;
+	std::string actual;
+	e::string_sink sink(&actual);
+	e::static_packer<e::string_sink>(&sink) << v32 << v64;
+	ASSERT_TRUE(expected == actual);
+}
+
+// A sink that is not derived from e::static_sink
+class plain_sink
+{
+public:
+	plain_sink() : bytes() {}
+
+public:
+	void write(size_t off, const uint8_t *ptr, size_t ptr_sz)
+	{
+		bytes.resize(std::max(bytes.size(), off + ptr_sz));
+		memmove(&bytes[off], ptr, ptr_sz);
+	}
+
+public:
+	std::string bytes;
+};
+
+TEST(StaticPackerTest, PlainSink)
+{
+	std::pair<uint8_t, uint32_t> p(7, 0xcafebabeUL);
+	std::string expected;
+	e::packer(&expected) << uint16_t(0x0102) << p << p;
+	plain_sink sink;
+	e::static_packer<plain_sink>(&sink) << uint16_t(0x0102) << p << p;
+	ASSERT_TRUE(expected == sink.bytes);
+}
+
+TEST(StaticPackerTest, BufferSink)
+{
+	std::auto_ptr<e::buffer> buf(e::buffer::create(16));
+	e::buffer_sink sink(buf.get());
+	e::static_packer<e::buffer_sink> pa(&sink);
+	pa = pa << uint32_t(0xdeadbeefUL);
+	pa = pa << uint32_t(0xcafebabeUL);
+	ASSERT_EQ(8U, pa.offset());
+	ASSERT_TRUE(buf->cmp("\xde\xad\xbe\xef\xca\xfe\xba\xbe", 8));
+}
+
+TEST(StaticPackerTest, BackPatch)
+{
+	std::string s;
+	e::string_sink sink(&s);
+	e::static_packer<e::string_sink> header(&sink);
+	e::static_packer<e::string_sink> body = header << uint16_t(0);
+	body = body << e::slice("hello", 5);
+	header << uint16_t(body.offset());
+	ASSERT_TRUE(s == std::string("\x00\x08\x05hello", 8));
+	e::static_packer<e::string_sink>(&sink, 10) << uint8_t(1);
+	ASSERT_EQ(11U, s.size());
+	ASSERT_EQ('\0', s[9]);
+	ASSERT_EQ('\x01', s[10]);
+}
+
+TEST(StaticPackerTest, FixedPack)
+{
+	std::string expected;
+	e::packer(&expected) << e::pack_fixed(uint32_t(1), uint16_t(2), uint8_t(3));
+	std::string actual;
+	e::string_sink sink(&actual);
+	e::static_packer<e::string_sink> pa(&sink);
+	pa = pa << e::pack_fixed(uint32_t(1), uint16_t(2), uint8_t(3));
+	ASSERT_EQ(7U, pa.offset());
+	ASSERT_TRUE(expected == actual);
+}
+
+} // namespace
@@ -6,6 +6,11 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#define __STDC_LIMIT_MACROS
+
+// C
+#include <stdint.h>
+
 // STL
 #include <vector>
 
@@ -124,3 +129,135 @@ TEST(Coding, Varint64Truncation)
 	ASSERT_TRUE(e::varint64_decode(s.data(), s.data() + s.size(), &result) != NULL);
 	ASSERT_EQ(large_value, result);
 }
+
+TEST(Coding, Zigzag)
+{
+	ASSERT_EQ(0U, e::zigzag_encode(0));
+	ASSERT_EQ(1U, e::zigzag_encode(-1));
+	ASSERT_EQ(2U, e::zigzag_encode(1));
+	ASSERT_EQ(3U, e::zigzag_encode(-2));
+	ASSERT_EQ(~static_cast<uint64_t>(0), e::zigzag_encode(INT64_MIN));
+	ASSERT_EQ(~static_cast<uint64_t>(0) - 1, e::zigzag_encode(INT64_MAX));
+	int64_t values[] = {0, 1, -1, 63, -64, 64, -65, INT64_MAX, INT64_MIN};
+
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+	{
+		ASSERT_EQ(values[i], e::zigzag_decode(e::zigzag_encode(values[i])));
+	}
+}
+
+TEST(Coding, Varint64DecodeN)
+{
+	// Runs of single-byte values interleaved with every encoded length
+	std::vector<uint64_t> values;
+
+	for (uint32_t k = 0; k < 64; k++)
+	{
+		for (uint32_t j = 0; j < k % 19; ++j)
+		{
+			values.push_back(j * 5 % 128);
+		}
+
+		values.push_back(1ull << k);
+		values.push_back((1ull << k) - 1);
+	}
+
+	values.push_back(~static_cast<uint64_t>(0));
+	std::string s;
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		char buf[10];
+		char *ptr = e::varint64_encode(buf, values[i]);
+		s += std::string(buf, ptr - buf);
+	}
+
+	// Every prefix must agree with the single-value decoder
+	std::vector<uint64_t> actual(values.size());
+	const char *p = s.data();
+	const char *limit = p + s.size();
+
+	for (size_t n = 0; n <= values.size(); ++n)
+	{
+		const char *expect = p;
+		uint64_t v;
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			expect = e::varint64_decode(expect, limit, &v);
+			ASSERT_TRUE(expect != NULL);
+		}
+
+		ASSERT_TRUE(e::varint64_decode_n(p, limit, &actual[0], n) == expect);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			ASSERT_EQ(values[i], actual[i]);
+		}
+	}
+
+	// Cutting the input anywhere short of the last value fails
+	for (const char *cut = p; cut < limit; ++cut)
+	{
+		ASSERT_TRUE(e::varint64_decode_n(p, cut, &actual[0], values.size()) == NULL);
+	}
+}
+
+TEST(Coding, Varint64DecodeNInvalid)
+{
+	// eleven bytes with the continuation bit set is never a varint64
+	std::string s(32, '\x01');
+	s.replace(20, 11, "\x81\x82\x83\x84\x85\x81\x82\x83\x84\x85\x81");
+	uint64_t out[32];
+	ASSERT_TRUE(e::varint64_decode_n(s.data(), s.data() + s.size(), out, 21) == NULL);
+	ASSERT_TRUE(e::varint64_decode_n(s.data(), s.data() + s.size(), out, 20) == s.data() + 20);
+
+	for (size_t i = 0; i < 20; ++i)
+	{
+		ASSERT_EQ(1U, out[i]);
+	}
+}
+
+TEST(Coding, VarintLength)
+{
+	ASSERT_EQ(1, e::varint_length(0));
+
+	for (uint32_t k = 0; k < 64; k++)
+	{
+		const uint64_t power = 1ull << k;
+		ASSERT_EQ(static_cast<int>(k / 7 + 1), e::varint_length(power));
+		ASSERT_EQ(static_cast<int>(k == 0 ? 1 : (k - 1) / 7 + 1), e::varint_length(power - 1));
+	}
+
+	ASSERT_EQ(10, e::varint_length(~static_cast<uint64_t>(0)));
+}
+
+TEST(Coding, Varint64EncodeN)
+{
+	std::vector<uint64_t> values;
+	values.push_back(0);
+	values.push_back(~static_cast<uint64_t>(0));
+
+	for (uint32_t k = 0; k < 64; k++)
+	{
+		values.push_back(1ull << k);
+		values.push_back((1ull << k) - 1);
+		values.push_back((1ull << k) + 1);
+		values.push_back(k);
+	}
+
+	std::string expected;
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		char buf[10];
+		char *ptr = e::varint64_encode(buf, values[i]);
+		expected += std::string(buf, ptr - buf);
+	}
+
+	ASSERT_EQ(expected.size(), e::varint_length_n(&values[0], values.size()));
+	std::vector<char> actual(expected.size());
+	char *end = e::varint64_encode_n(&actual[0], &values[0], values.size());
+	ASSERT_EQ(expected.size(), static_cast<size_t>(end - &actual[0]));
+	ASSERT_TRUE(expected == std::string(&actual[0], actual.size()));
+}
@@ -8,10 +8,19 @@
 
 // C
 #include <stdlib.h>
+#include <string.h>
 
 // e
 #include "e/varint.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define E_VARINT_SWAR 1
+#endif
+
 namespace
 {
 
@@ -84,6 +93,81 @@ e :: varint64_decode(const char *p, const char *limit, uint64_t *value)
 	return NULL;
 }
 
+const char *
+e :: varint64_decode_n(const char *p, const char *limit, uint64_t *out, size_t n)
+{
+	size_t i = 0;
+
+	while (i < n)
+	{
+#if defined(__SSE2__)
+		// sixteen values that are each a single byte: widen them all at once
+		if (n - i >= 16 && limit - p >= 16)
+		{
+			const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+			if (_mm_movemask_epi8(x) == 0)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i lo16 = _mm_unpacklo_epi8(x, zero);
+				const __m128i hi16 = _mm_unpackhi_epi8(x, zero);
+				const __m128i w[4] = {_mm_unpacklo_epi16(lo16, zero),
+				                      _mm_unpackhi_epi16(lo16, zero),
+				                      _mm_unpacklo_epi16(hi16, zero),
+				                      _mm_unpackhi_epi16(hi16, zero)};
+
+				for (int j = 0; j < 4; ++j)
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 4 * j),
+					                 _mm_unpacklo_epi32(w[j], zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 4 * j + 2),
+					                 _mm_unpackhi_epi32(w[j], zero));
+				}
+
+				p += 16;
+				i += 16;
+				continue;
+			}
+		}
+#endif
+
+#ifdef E_VARINT_SWAR
+		// a value of at most eight bytes: find its last byte from the
+		// continuation bits and squeeze out the 7-bit groups without a loop
+		if (limit - p >= 8)
+		{
+			uint64_t x;
+			memcpy(&x, p, 8);
+			const uint64_t stops = ~x & 0x8080808080808080ULL;
+
+			if (stops)
+			{
+				const unsigned bytes = (__builtin_ctzll(stops) + 1) / 8;
+				x &= bytes == 8 ? ~0ULL : (1ULL << (bytes * 8)) - 1;
+				x &= 0x7f7f7f7f7f7f7f7fULL;
+				x = ((x & 0x7f007f007f007f00ULL) >> 1) | (x & 0x007f007f007f007fULL);
+				x = ((x & 0x3fff00003fff0000ULL) >> 2) | (x & 0x00003fff00003fffULL);
+				x = ((x & 0x0fffffff00000000ULL) >> 4) | (x & 0x000000000fffffffULL);
+				out[i++] = x;
+				p += bytes;
+				continue;
+			}
+		}
+#endif
+
+		p = varint64_decode(p, limit, out + i);
+
+		if (!p)
+		{
+			return NULL;
+		}
+
+		++i;
+	}
+
+	return p;
+}
+
 char *
 e :: varint32_encode(char *dst, uint32_t v)
 {
@@ -136,3 +220,51 @@ e :: varint64_encode(char *dst, uint64_t v)
 	*(ptr++) = static_cast<unsigned char>(v);
 	return reinterpret_cast<char *>(ptr);
 }
+
+char *
+e :: varint64_encode_n(char *dst, const uint64_t *v, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		uint64_t x = v[i];
+
+		if (x < 128)
+		{
+			*dst++ = static_cast<char>(x);
+			continue;
+		}
+
+#ifdef E_VARINT_SWAR
+		if (x < (1ULL << 56))
+		{
+			// spread the 7-bit groups one per byte, then set the
+			// continuation bit on every byte except the last
+			const unsigned bytes = varint_length(x);
+			x = ((x << 4) & 0x0fffffff00000000ULL) | (x & 0x000000000fffffffULL);
+			x = ((x << 2) & 0x3fff00003fff0000ULL) | (x & 0x00003fff00003fffULL);
+			x = ((x << 1) & 0x7f007f007f007f00ULL) | (x & 0x007f007f007f007fULL);
+			x |= 0x8080808080808080ULL & ((1ULL << ((bytes - 1) * 8)) - 1);
+			memcpy(dst, &x, bytes);
+			dst += bytes;
+			continue;
+		}
+#endif
+
+		dst = varint64_encode(dst, x);
+	}
+
+	return dst;
+}
+
+size_t
+e :: varint_length_n(const uint64_t *v, size_t n)
+{
+	size_t sz = 0;
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		sz += varint_length(v[i]);
+	}
+
+	return sz;
+}